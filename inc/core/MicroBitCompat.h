@@ -103,9 +103,31 @@ int string_reverse(char *s);
   * @param n The number to convert.
   *
   * @param s A pointer to the buffer where the resulting string will be stored.
+  *          This needs room for at least 12 characters.
   *
   * @return MICROBIT_OK, or MICROBIT_INVALID_PARAMETER.
   */
 int itoa(int n, char *s);
 
+/**
+  * Converts a fixed point decimal number into a string representation, such as a
+  * temperature held in tenths of a degree. No division or heap allocation is used.
+  *
+  * @param value The number to convert, scaled up by 10 to the power of places.
+  *
+  * @param places The number of digits after the decimal point, from 0 to 9.
+  *
+  * @param s A pointer to the buffer where the resulting string will be stored.
+  *          This needs room for at least 13 characters.
+  *
+  * @return The number of characters written, excluding the terminator, or MICROBIT_INVALID_PARAMETER.
+  *
+  * @code
+  * char s[13];
+  * fixed_itoa(-1234, 2, s); // "-12.34"
+  * fixed_itoa(5, 3, s);     // "0.005"
+  * @endcode
+  */
+int fixed_itoa(int value, int places, char *s);
+
 #endif
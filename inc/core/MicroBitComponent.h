@@ -72,6 +72,7 @@ DEALINGS IN THE SOFTWARE.
 #define MICROBIT_ID_IO_INT2             34          //INT2
 #define MICROBIT_ID_IO_INT3             35          //INT3
 #define MICROBIT_ID_PARTIAL_FLASHING    36
+#define MICROBIT_ID_SYSTEM_TIMER        37          // Periodic callbacks dispatched via the message bus
 
 #define MICROBIT_ID_MESSAGE_BUS_LISTENER            1021          // Message bus indication that a handler for a given ID has been registered.
 #define MICROBIT_ID_NOTIFY_ONE                      1022          // Notfication channel, for general purpose synchronisation
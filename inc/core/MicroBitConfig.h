@@ -125,6 +125,14 @@ extern uint32_t __etext;
 #define MICROBIT_HEAP_BLOCK_SIZE                4
 #endif
 
+// The amount of memory (bytes) reserved at the top of the heap for allocations made in interrupt context,
+// such as radio receive buffers and queued MessageBus events.
+// When non-zero, interrupt handlers allocate only from this region, which allows the main heap to be searched
+// with interrupts enabled. Must be a multiple of MICROBIT_HEAP_BLOCK_SIZE. Set to '0' to disable.
+#ifndef MICROBIT_HEAP_IRQ_SIZE
+#define MICROBIT_HEAP_IRQ_SIZE                  0
+#endif
+
 // If defined, reuse any unused SRAM normally reserved for SoftDevice (Nordic's memory resident BLE stack) as heap memory.
 // The amount of memory reused depends upon whether or not BLE is enabled using MICROBIT_BLE_ENABLED.
 // Set '1' to enable.
@@ -149,6 +157,13 @@ extern uint32_t __etext;
 #define SYSTEM_TICK_PERIOD_MS                   6
 #endif
 
+// The interval (milliseconds) at which buttons and touch sensitive pins are sampled.
+// Debounce thresholds are scaled to match, so the debounce time stays about the same.
+// Should be a multiple of SYSTEM_TICK_PERIOD_MS.
+#ifndef MICROBIT_BUTTON_SAMPLE_PERIOD
+#define MICROBIT_BUTTON_SAMPLE_PERIOD           12
+#endif
+
 //
 // Message Bus:
 // Default behaviour for event handlers, if not specified in the listen() call
@@ -182,6 +197,13 @@ extern uint32_t __etext;
 #define MICROBIT_SYSTEM_COMPONENTS              10
 #endif
 
+// Enable this to measure the time each system component spends in its systemTick() callback.
+// Results are available through system_timer_get_component_time().
+// Set '1' to enable.
+#ifndef MICROBIT_SYSTEM_TICK_PROFILING
+#define MICROBIT_SYSTEM_TICK_PROFILING          0
+#endif
+
 // To reduce memory cost and complexity, the micro:bit allows components to register for
 // periodic callback events when the processor is idle.
 // This defines the maximum size of the idle callback list.
@@ -387,6 +409,13 @@ extern uint32_t __etext;
 #define MICROBIT_DISPLAY_DEFAULT_BRIGHTNESS     MICROBIT_DISPLAY_MAXIMUM_BRIGHTNESS
 #endif
 
+// Enables perceptual (CIE lightness) correction of the display brightness and greyscale pixel values.
+// Disabled by default, as it changes how bright existing programs appear at any given setting.
+// Set to 1 to enable, or 0 to map them linearly onto LED on time.
+#ifndef MICROBIT_DISPLAY_GAMMA_CORRECTION
+#define MICROBIT_DISPLAY_GAMMA_CORRECTION       0
+#endif
+
 // Selects the default scroll speed for the display.
 // The time taken to move a single pixel (ms).
 #ifndef MICROBIT_DEFAULT_SCROLL_SPEED
@@ -398,6 +427,30 @@ extern uint32_t __etext;
 #define MICROBIT_DEFAULT_SCROLL_STRIDE          -1
 #endif
 
+// The largest strip (in columns, one byte each) that scrollAsync() will pre-render text into.
+// Longer strings are rendered glyph by glyph as they scroll. Set to 0 to disable pre-rendering.
+#ifndef MICROBIT_DISPLAY_SCROLL_STRIP_MAX
+#define MICROBIT_DISPLAY_SCROLL_STRIP_MAX       256
+#endif
+
+// Enable this to lay out scrolling text proportionally, with each character only as wide as its glyph,
+// so messages take fewer frames to scroll. This can also be changed at runtime with setProportionalText().
+// Set '1' to enable.
+#ifndef MICROBIT_DISPLAY_PROPORTIONAL_TEXT
+#define MICROBIT_DISPLAY_PROPORTIONAL_TEXT      0
+#endif
+
+// The number of rasterized font glyphs kept in RAM for drawing text. Each entry costs 13 bytes.
+// Must be a power of two.
+#ifndef MICROBIT_FONT_GLYPH_CACHE_SIZE
+#define MICROBIT_FONT_GLYPH_CACHE_SIZE          16
+#endif
+
+// The maximum number of items that may be waiting in the display's animation playlist.
+#ifndef MICROBIT_DISPLAY_PLAYLIST_SIZE
+#define MICROBIT_DISPLAY_PLAYLIST_SIZE          8
+#endif
+
 // Selects the time each character will be shown on the display during print operations.
 // The time each character is shown on the screen  (ms).
 #ifndef MICROBIT_DEFAULT_PRINT_SPEED
@@ -453,6 +506,72 @@ extern uint32_t __etext;
 #define MICROBIT_PANIC_HEAP_FULL                1
 #endif
 
+//
+// Managed type options
+//
+
+// Enable this to give ManagedString, MicroBitImage, PacketBuffer and ManagedType move constructors
+// and move assignment, so temporaries hand over their data without touching its reference count.
+// Requires a C++11 compiler, and is enabled by default when one is in use.
+// Set '1' to enable.
+#ifndef MICROBIT_MOVE_SEMANTICS
+#if __cplusplus >= 201103L
+#define MICROBIT_MOVE_SEMANTICS                 1
+#else
+#define MICROBIT_MOVE_SEMANTICS                 0
+#endif
+#endif
+
+// The number of distinct strings that ManagedString::intern() can hold.
+// Each entry costs 6 bytes of RAM, plus the string itself, which is never freed.
+#ifndef MICROBIT_STRING_INTERN_TABLE_SIZE
+#define MICROBIT_STRING_INTERN_TABLE_SIZE       16
+#endif
+
+// The size (bytes) of a ManagedString object. Strings of up to two characters fewer than this
+// are held inside the object itself, with no heap allocation or reference counting.
+// Larger values keep more strings off the heap, but make every ManagedString larger.
+// Must be at least the size of a pointer, and at most 128. Set to 4 to keep ManagedString the size of a pointer.
+#ifndef MICROBIT_STRING_INLINE_SIZE
+#define MICROBIT_STRING_INLINE_SIZE             8
+#endif
+
+// Enable this to serve the payloads of ManagedString, PacketBuffer and MicroBitImage from fixed size
+// block pools where they fit, falling back to the heap when they do not. This makes allocation constant time
+// and keeps short lived payloads from fragmenting the heap, at the cost of reserving the pool memory up front.
+// Set '1' to enable.
+#ifndef MICROBIT_POOL_ENABLED
+#define MICROBIT_POOL_ENABLED                   0
+#endif
+
+// The size (bytes) and number of blocks in each pool. Sizes must be increasing multiples of 4,
+// and each pool may hold up to 32 blocks. A StringData payload needs 5 bytes plus its length,
+// and a PacketData payload 12 bytes plus its length, so the defaults hold strings of up to 11 and 27
+// characters, and any radio packet.
+#ifndef MICROBIT_POOL_SMALL_SIZE
+#define MICROBIT_POOL_SMALL_SIZE                16
+#endif
+
+#ifndef MICROBIT_POOL_SMALL_BLOCKS
+#define MICROBIT_POOL_SMALL_BLOCKS              16
+#endif
+
+#ifndef MICROBIT_POOL_MEDIUM_SIZE
+#define MICROBIT_POOL_MEDIUM_SIZE               32
+#endif
+
+#ifndef MICROBIT_POOL_MEDIUM_BLOCKS
+#define MICROBIT_POOL_MEDIUM_BLOCKS             16
+#endif
+
+#ifndef MICROBIT_POOL_LARGE_SIZE
+#define MICROBIT_POOL_LARGE_SIZE                48
+#endif
+
+#ifndef MICROBIT_POOL_LARGE_BLOCKS
+#define MICROBIT_POOL_LARGE_BLOCKS              8
+#endif
+
 //
 // Debug options
 //
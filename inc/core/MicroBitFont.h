@@ -34,6 +34,20 @@ DEALINGS IN THE SOFTWARE.
 #define MICROBIT_FONT_ASCII_START 32
 #define MICROBIT_FONT_ASCII_END 126
 
+// The width given to a glyph with no lit pixels, such as a space, when text is laid out proportionally.
+#define MICROBIT_FONT_SPACE_WIDTH 2
+
+/**
+  * A character of a MicroBitFont, pre-rasterized into the forms used to draw it.
+  */
+struct MicroBitGlyph
+{
+    uint8_t rows[MICROBIT_FONT_HEIGHT];     // Each row of the glyph, with its leftmost pixel in bit 0.
+    uint8_t columns[MICROBIT_FONT_WIDTH];   // Each column of the glyph, with its top pixel in bit 0.
+    uint8_t offset;                         // The leftmost column holding a lit pixel.
+    uint8_t width;                          // The number of columns from offset to the rightmost lit pixel, or MICROBIT_FONT_SPACE_WIDTH if none are lit.
+};
+
 /**
   * Class definition for a MicrobitFont
   * This class represents a font that can be used by the display to render text.
@@ -95,6 +109,20 @@ class MicroBitFont
       */
     static MicroBitFont getSystemFont();
 
+    /**
+      * Provides a character of this font, pre-rasterized into row and column masks.
+      *
+      * Recently used glyphs are kept in a small cache, shared by all fonts, so drawing
+      * the same characters repeatedly does not decode them each time.
+      *
+      * @param c The character to fetch.
+      *
+      * @param glyph The MicroBitGlyph to fill in.
+      *
+      * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the font has no such character.
+      */
+    int getGlyph(char c, MicroBitGlyph *glyph) const;
+
 };
 
 #endif
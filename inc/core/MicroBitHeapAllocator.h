@@ -83,6 +83,25 @@ struct HeapDefinition
   * simply use the standard heap.
   */
 int microbit_create_heap(uint32_t start, uint32_t end);
+
+/**
+  * Create and initialise a given memory region as a heap dedicated to interrupt context allocations.
+  * Once created, any call to malloc or new made from an interrupt service routine is satisfied
+  * from this region only, and never from the main heaps. As interrupt handlers can then never
+  * modify the main heaps, allocations made from thread context run with interrupts enabled.
+  *
+  * @param start The start address of memory to use as the interrupt heap region.
+  *
+  * @param end The end address of memory to use as the interrupt heap region.
+  *
+  * @return MICROBIT_OK on success, MICROBIT_NOT_SUPPORTED if an interrupt heap already exists,
+  *         or MICROBIT_INVALID_PARAMETER if the region is not valid.
+  *
+  * @note Memory from this heap may be released from any context. A heap of MICROBIT_HEAP_IRQ_SIZE
+  * bytes is created automatically at the top of the main heap if that option is non-zero.
+  */
+int microbit_create_irq_heap(uint32_t start, uint32_t end);
+
 void microbit_heap_print();
 
 #endif
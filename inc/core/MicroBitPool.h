@@ -0,0 +1,114 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 British Broadcasting Corporation.
+This software is provided by Lancaster University by arrangement with the BBC.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef MICROBIT_POOL_H
+#define MICROBIT_POOL_H
+
+#include "mbed.h"
+#include "MicroBitConfig.h"
+
+/**
+  * Fixed size block pools for the payloads of the managed types.
+  *
+  * ManagedString, PacketBuffer and MicroBitImage allocate and release small payloads
+  * at a high rate - a received radio packet, a number turned into a string, a short
+  * concatenation. Each of these costs a first fit search of the heap, and over time
+  * leaves the heap fragmented with small holes.
+  *
+  * When MICROBIT_POOL_ENABLED is set, a few statically allocated pools of equally sized
+  * blocks are reserved instead. A request is served from the smallest pool whose blocks
+  * are large enough, in constant time. If the request is too large, or that pool is full,
+  * it falls back to the heap transparently.
+  */
+
+// The number of size classes, from smallest to largest.
+#define MICROBIT_POOL_CLASSES           3
+
+/**
+  * Usage statistics for a single pool.
+  */
+struct MicroBitPoolStats
+{
+    uint16_t blockSize;     // The size of each block in this pool, in bytes.
+    uint16_t blocks;        // The number of blocks in this pool.
+    uint16_t used;          // The number of blocks currently allocated.
+    uint16_t peak;          // The largest number of blocks that have been allocated at once.
+    uint32_t hits;          // The number of requests served from this pool.
+    uint32_t misses;        // The number of requests for this size class that fell back to the heap as the pool was full.
+};
+
+#if CONFIG_ENABLED(MICROBIT_POOL_ENABLED)
+
+/**
+  * Allocates a block of memory, from a pool if a suitable block is free, or from the heap otherwise.
+  *
+  * @param size The amount of memory, in bytes, to allocate.
+  *
+  * @return A pointer to the allocated memory, or NULL if insufficient memory is available.
+  *
+  * @note Memory returned by this function must be released with microbit_pool_free().
+  */
+void *microbit_pool_alloc(size_t size);
+
+/**
+  * Releases a block of memory obtained from microbit_pool_alloc(), returning it to its pool
+  * or to the heap as appropriate.
+  *
+  * @param p The memory to release. May be NULL.
+  */
+void microbit_pool_free(void *p);
+
+#else
+
+inline void *microbit_pool_alloc(size_t size)
+{
+    return malloc(size);
+}
+
+inline void microbit_pool_free(void *p)
+{
+    free(p);
+}
+
+#endif
+
+/**
+  * Reads the usage statistics for a given pool.
+  *
+  * @param sizeClass The pool to query, in the range 0..MICROBIT_POOL_CLASSES-1, smallest first.
+  *
+  * @param stats The structure to fill in.
+  *
+  * @return MICROBIT_OK on success, MICROBIT_INVALID_PARAMETER if sizeClass is out of range,
+  *         or MICROBIT_NOT_SUPPORTED if pools are disabled.
+  */
+int microbit_pool_stats(int sizeClass, MicroBitPoolStats *stats);
+
+/**
+  * Resets the peak, hit and miss counters of all pools.
+  */
+void microbit_pool_reset_stats();
+
+#endif
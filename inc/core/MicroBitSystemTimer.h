@@ -30,8 +30,9 @@ DEALINGS IN THE SOFTWARE.
   *
   * 1) a concept of global system time since power up
   * 2) a simple periodic multiplexing API for the underlying mbed implementation.
+  * 3) a queue of one-shot and periodic callbacks, sorted by deadline and driven by a single hardware timer.
   *
-  * The latter is useful to avoid costs associated with multiple mbed Ticker instances
+  * The latter two are useful to avoid costs associated with multiple mbed Ticker instances
   * in microbit-dal components, as each incurs a significant additional RAM overhead (circa 80 bytes).
   */
 
@@ -42,6 +43,94 @@ DEALINGS IN THE SOFTWARE.
 #include "MicroBitConfig.h"
 #include "MicroBitComponent.h"
 
+/**
+  * A callback scheduled on the system timer queue.
+  *
+  * Events are owned by the caller (typically as a member of a driver) and are linked into a single queue,
+  * sorted by deadline. Only the event at the head of the queue occupies the hardware timer.
+  *
+  * @note deadlines are held modulo 2^32 microseconds, so a single interval must be less than ~35 minutes.
+  */
+struct MicroBitSystemTimerEvent
+{
+    uint32_t                    timestamp;      // Deadline of the next callback, in microseconds since power on (modulo 2^32).
+    uint32_t                    period;         // Interval between callbacks in microseconds, or zero for a one-shot event.
+    uint32_t                    maxLateness;    // The largest observed delay between a deadline and its callback, in microseconds.
+    uint32_t                    overruns;       // The number of periodic deadlines skipped as the callback ran over a whole period late.
+    void                        (*cb)(void *);  // The function to invoke. Called in interrupt context.
+    void                        *cb_arg;        // The argument passed to the callback.
+    MicroBitSystemTimerEvent    *next;
+
+    /**
+      * Constructor.
+      *
+      * @param handler The function to call when this event is due.
+      *
+      * @param arg An optional argument to pass to the handler.
+      */
+    MicroBitSystemTimerEvent(void (*handler)(void *), void *arg = NULL)
+    {
+        timestamp = 0;
+        period = 0;
+        maxLateness = 0;
+        overruns = 0;
+        cb = handler;
+        cb_arg = arg;
+        next = NULL;
+    }
+};
+
+/**
+  * Defines the context in which a callback registered with system_timer_every() is invoked.
+  */
+enum SystemTimerCallbackMode
+{
+    SYSTEM_TIMER_CALLBACK_IRQ,              // Called directly from the timer interrupt.
+    SYSTEM_TIMER_CALLBACK_MESSAGE_BUS       // Queued on the message bus, and called as a non-blocking handler in thread context.
+};
+
+/**
+  * A periodic callback created by system_timer_every().
+  *
+  * In addition to the statistics held by MicroBitSystemTimerEvent, this records the lateness of each call
+  * as seen by the callback itself, which includes any time spent waiting on the message bus.
+  */
+struct MicroBitPeriodicCallback : MicroBitSystemTimerEvent
+{
+    void                        (*fn)(void);    // The user function to invoke.
+    uint8_t                     mode;           // The SystemTimerCallbackMode for this callback.
+    uint8_t                     pending;        // Set when an event has been raised on the message bus, but not yet handled.
+    uint16_t                    value;          // The event value used on the message bus, unique to this callback.
+    uint32_t                    deadline;       // The deadline of the most recent call, in microseconds (modulo 2^32).
+    uint32_t                    calls;          // The number of times the callback has been invoked.
+    uint32_t                    totalLateness;  // The sum of the lateness of every call, in microseconds.
+
+    MicroBitPeriodicCallback(void (*handler)(void *)) : MicroBitSystemTimerEvent(handler, this)
+    {
+        fn = NULL;
+        mode = SYSTEM_TIMER_CALLBACK_IRQ;
+        pending = 0;
+        value = 0;
+        deadline = 0;
+        calls = 0;
+        totalLateness = 0;
+    }
+};
+
+/**
+  * A template used to create a plain function that invokes a given C++ member function,
+  * suitable for use as the handler of a MicroBitSystemTimerEvent.
+  *
+  * @code
+  * MicroBitSystemTimerEvent evt(system_timer_method_call<MicroBitDisplay, &MicroBitDisplay::renderFinish>, this);
+  * @endcode
+  */
+template <typename T, void (T::*method)()>
+void system_timer_method_call(void *object)
+{
+    (((T *)object)->*method)();
+}
+
 /**
   * Initialises a system wide timer, used to drive the various components used in the runtime.
   *
@@ -72,7 +161,10 @@ int system_timer_get_period();
 /**
   * Updates the current time in microseconds, since power on.
   *
-  * If the mbed Timer hasn't been initialised, it will be initialised
+  * The time is read from the free running mbed us_ticker, which is never reset, and
+  * extended to 64 bits by counting the times it has wrapped.
+  *
+  * If the system timer hasn't been initialised, it will be initialised
   * on the first call to this function.
   */
 inline void update_time();
@@ -101,20 +193,26 @@ void system_timer_tick();
 
 /**
   * Add a component to the array of system components. This component will then receive
-  * periodic callbacks, once every tick period in interrupt context.
+  * periodic callbacks in interrupt context, once every tick period, or at the nearest tick to the given period.
   *
   * @param component The component to add.
   *
-  * @return MICROBIT_OK on success or MICROBIT_NO_RESOURCES if the component array is full.
+  * @param period The interval between callbacks in milliseconds, or zero to be called on every tick. Defaults to zero.
+  *
+  * @return MICROBIT_OK on success, MICROBIT_NO_RESOURCES if the component array is full,
+  *         or MICROBIT_INVALID_PARAMETER if the period is out of range.
   *
   * @code
   * // heap allocated - otherwise it will be paged out!
   * MicroBitDisplay* display = new MicroBitDisplay();
   *
   * system_timer_add_component(display);
+  *
+  * // A component that only needs servicing every 100ms.
+  * system_timer_add_component(thermometer, 100);
   * @endcode
   */
-int system_timer_add_component(MicroBitComponent *component);
+int system_timer_add_component(MicroBitComponent *component, int period = 0);
 
 /**
   * Remove a component from the array of system components. This component will no longer receive
@@ -135,6 +233,95 @@ int system_timer_add_component(MicroBitComponent *component);
   */
 int system_timer_remove_component(MicroBitComponent *component);
 
+/**
+  * Retrieves the time spent in interrupt context by a given component's systemTick() callback.
+  *
+  * @param component The component to query.
+  *
+  * @param total_us If not NULL, set to the total time spent in the callback since the component was added, in microseconds.
+  *
+  * @param max_us If not NULL, set to the longest single invocation of the callback, in microseconds.
+  *
+  * @return MICROBIT_OK on success, MICROBIT_INVALID_PARAMETER if the given component has not been previously added,
+  *         or MICROBIT_NOT_SUPPORTED if MICROBIT_SYSTEM_TICK_PROFILING is disabled.
+  */
+int system_timer_get_component_time(MicroBitComponent *component, uint32_t *total_us, uint32_t *max_us);
+
+/**
+  * Schedules a single callback, the given number of microseconds from now.
+  * If the event is already scheduled, it is first removed from the queue.
+  *
+  * @param evt The event to schedule. This must remain valid until it has fired or has been cancelled.
+  *
+  * @param interval_us The time from now until the callback is due, in microseconds.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if evt is NULL or has no handler.
+  *
+  * @note The callback will be in interrupt context.
+  */
+int system_timer_event_after_us(MicroBitSystemTimerEvent *evt, uint32_t interval_us);
+
+/**
+  * Schedules a periodic callback, first due one period from now.
+  * Deadlines advance by exactly one period each time, so callbacks do not drift.
+  * If the event is already scheduled, it is first removed from the queue.
+  *
+  * @param evt The event to schedule. This must remain valid until it has been cancelled.
+  *
+  * @param period_us The period between callbacks, in microseconds.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if evt is NULL, has no handler or period_us is zero.
+  *
+  * @note The callback will be in interrupt context.
+  */
+int system_timer_event_every_us(MicroBitSystemTimerEvent *evt, uint32_t period_us);
+
+/**
+  * Removes an event from the timer queue. Its callback will not be invoked again until it is rescheduled.
+  *
+  * @param evt The event to cancel.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the event was not scheduled.
+  */
+int system_timer_cancel_event(MicroBitSystemTimerEvent *evt);
+
+/**
+  * Calls the given function periodically, without requiring a fiber.
+  *
+  * Deadlines are calculated from the time of registration, so calls do not drift however long the callback takes.
+  * If a call is more than a whole period late, missed calls are skipped and counted as overruns rather than
+  * being delivered in a burst. In SYSTEM_TIMER_CALLBACK_MESSAGE_BUS mode, a period is also counted as an overrun
+  * if the previous call is still waiting on the message bus.
+  *
+  * @param period_us The period between calls, in microseconds.
+  *
+  * @param callback The function to call.
+  *
+  * @param mode The context in which to call the function. Defaults to SYSTEM_TIMER_CALLBACK_IRQ.
+  *
+  * @return A handle that records lateness statistics and may be passed to system_timer_cancel_every(),
+  *         or NULL if the parameters are invalid or insufficient resources are available.
+  *
+  * @code
+  * void sample()
+  * {
+  *     // called at 100Hz...
+  * }
+  *
+  * MicroBitPeriodicCallback *cb = system_timer_every(10000, sample, SYSTEM_TIMER_CALLBACK_MESSAGE_BUS);
+  * @endcode
+  */
+MicroBitPeriodicCallback *system_timer_every(uint32_t period_us, void (*callback)(void), SystemTimerCallbackMode mode = SYSTEM_TIMER_CALLBACK_IRQ);
+
+/**
+  * Stops and releases a periodic callback created by system_timer_every().
+  *
+  * @param cb The handle returned by system_timer_every().
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the callback is not active.
+  */
+int system_timer_cancel_every(MicroBitPeriodicCallback *cb);
+
 /**
   * A simple C/C++ wrapper to allow periodic callbacks to standard C functions transparently.
   */
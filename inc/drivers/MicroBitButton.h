@@ -50,10 +50,14 @@ DEALINGS IN THE SOFTWARE.
 #define MICROBIT_BUTTON_STATE_CLICK             4
 #define MICROBIT_BUTTON_STATE_LONG_CLICK        8
 
+// The debounce thresholds below are counted in samples. They were chosen for a sample every 6ms,
+// so are scaled (rounding up) to give the same debounce time at MICROBIT_BUTTON_SAMPLE_PERIOD.
+#define MICROBIT_BUTTON_SIGMA_SAMPLES(n)        (((n) * 6 + MICROBIT_BUTTON_SAMPLE_PERIOD - 1) / MICROBIT_BUTTON_SAMPLE_PERIOD)
+
 #define MICROBIT_BUTTON_SIGMA_MIN               0
-#define MICROBIT_BUTTON_SIGMA_MAX               12
-#define MICROBIT_BUTTON_SIGMA_THRESH_HI         8
-#define MICROBIT_BUTTON_SIGMA_THRESH_LO         2
+#define MICROBIT_BUTTON_SIGMA_MAX               MICROBIT_BUTTON_SIGMA_SAMPLES(12)
+#define MICROBIT_BUTTON_SIGMA_THRESH_HI         MICROBIT_BUTTON_SIGMA_SAMPLES(8)
+#define MICROBIT_BUTTON_SIGMA_THRESH_LO         MICROBIT_BUTTON_SIGMA_SAMPLES(2)
 #define MICROBIT_BUTTON_DOUBLE_CLICK_THRESH     50
 
 enum MicroBitButtonEventConfiguration
@@ -34,19 +34,26 @@ DEALINGS IN THE SOFTWARE.
 #include "MicroBitFont.h"
 #include "MicroBitMatrixMaps.h"
 #include "MicroBitLightSensor.h"
+#include "MicroBitSystemTimer.h"
 
 /**
   * Event codes raised by MicroBitDisplay
   */
 #define MICROBIT_DISPLAY_EVT_ANIMATION_COMPLETE         1
 #define MICROBIT_DISPLAY_EVT_LIGHT_SENSE                2
+#define MICROBIT_DISPLAY_EVT_FRAME                      3
 
 //
 // Internal constants
 //
 #define MICROBIT_DISPLAY_DEFAULT_AUTOCLEAR      1
 #define MICROBIT_DISPLAY_SPACING                1
-#define MICROBIT_DISPLAY_GREYSCALE_BIT_DEPTH    8
+#define MICROBIT_DISPLAY_GREYSCALE_BIT_DEPTH    6       // Bits of intensity shown for each pixel in greyscale mode.
+#define MICROBIT_DISPLAY_GREYSCALE_LONG_PLANES  5       // Bit planes long enough to be timed individually.
+#define MICROBIT_DISPLAY_GREYSCALE_SHORT_PLANES (MICROBIT_DISPLAY_GREYSCALE_BIT_DEPTH - MICROBIT_DISPLAY_GREYSCALE_LONG_PLANES)
+#define MICROBIT_DISPLAY_GREYSCALE_SLOTS        (MICROBIT_DISPLAY_GREYSCALE_LONG_PLANES + 1)
+#define MICROBIT_DISPLAY_FRAME_WORDS            (MICROBIT_DISPLAY_GREYSCALE_SLOTS + 1)  // Per row: each slot, then the first slot's alternate dither phase.
+
 #define MICROBIT_DISPLAY_ANIMATE_DEFAULT_POS    -255
 
 enum AnimationMode {
@@ -66,6 +73,25 @@ enum DisplayMode {
     DISPLAY_MODE_BLACK_AND_WHITE_LIGHT_SENSE
 };
 
+enum DisplayPlaylistItemType {
+    PLAYLIST_ITEM_PRINT_IMAGE,
+    PLAYLIST_ITEM_SCROLL_TEXT,
+    PLAYLIST_ITEM_SCROLL_IMAGE,
+    PLAYLIST_ITEM_ANIMATE_IMAGE
+};
+
+/**
+  * An animation waiting in a MicroBitDisplay playlist.
+  */
+struct MicroBitDisplayPlaylistItem
+{
+    ManagedString text;         // The text to scroll, for PLAYLIST_ITEM_SCROLL_TEXT.
+    MicroBitImage image;        // The image to show, for all other items.
+    uint16_t delay;             // The time between updates, or the time to show the image for, in milliseconds.
+    int8_t stride;              // The number of pixels to move in each update, for image scrolls and animations.
+    uint8_t type;               // One of DisplayPlaylistItemType.
+};
+
 enum DisplayRotation {
     MICROBIT_DISPLAY_ROTATION_0,
     MICROBIT_DISPLAY_ROTATION_90,
@@ -83,14 +109,32 @@ class MicroBitDisplay : public MicroBitComponent
     uint8_t width;
     uint8_t height;
     uint8_t brightness;
+    uint16_t brightnessDuty;
     uint8_t strobeRow;
     uint8_t rotation;
     uint8_t mode;
-    uint8_t greyscaleBitMsk;
     uint8_t timingCount;
+    uint8_t frameMode;
+    uint8_t greyscaleFrame;
     uint32_t col_mask;
 
-    Timeout renderTimer;
+    // The bitmap offset of each LED, in strobe order, for the current rotation.
+    uint16_t *pixelMap;
+
+    // The precompiled LEDMatrix words for each row (and greyscale bit plane) of the current frame,
+    // including both phases of the dithered greyscale slot.
+    uint32_t *frameData;
+
+    // The image state frameData was compiled from, and whether a setting it depends on has changed since.
+    const uint8_t *compiledBitmap;
+    uint32_t compiledWriteCount;
+    volatile bool frameDirty;
+
+    // The image applications draw into when double buffering, and whether it is waiting to be shown.
+    MicroBitImage backBuffer;
+    volatile bool swapPending;
+
+    MicroBitSystemTimerEvent renderTimer;
     PortOut *LEDMatrix;
 
     //
@@ -122,6 +166,24 @@ class MicroBitDisplay : public MicroBitComponent
     // The number of pixels the current character has been shifted on the display.
     uint8_t scrollingPosition;
 
+    // The number of columns the current character occupies, excluding spacing.
+    uint8_t scrollingCharWidth;
+
+    // Whether scrolling text is laid out proportionally, rather than in fixed width cells.
+    bool proportionalText;
+
+    // The text pre-rendered as packed columns (one bit per row), or NULL if none has been rendered yet.
+    uint8_t *scrollingStrip;
+
+    // The number of columns in use in the strip, or zero if the text is being rendered glyph by glyph.
+    uint16_t scrollingStripLength;
+
+    // The number of columns allocated for the strip.
+    uint16_t scrollingStripCapacity;
+
+    // The column of the strip shown at the left of the display.
+    int16_t scrollingStripPosition;
+
     //
     // State for printString() method.
     //
@@ -146,6 +208,16 @@ class MicroBitDisplay : public MicroBitComponent
     // The number of pixels the image is shifted on the display in each quantum.
     int8_t scrollingImageStride;
 
+    //
+    // State for the playlist methods.
+    //
+    // Animations waiting to be displayed, held in a circular buffer. NULL until first used.
+    MicroBitDisplayPlaylistItem *playlist;
+
+    // The index of the next item to display, and the number of items waiting.
+    uint8_t playlistHead;
+    uint8_t playlistCount;
+
     // A pointer to an instance of light sensor, if in use
     MicroBitLightSensor* lightSensor;
 
@@ -167,6 +239,29 @@ class MicroBitDisplay : public MicroBitComponent
       */
     void renderFinish();
 
+    /**
+      * Rebuilds the table of bitmap offsets used to compile each frame, taking into account
+      * the current rotation.
+      */
+    void compilePixelMap();
+
+    /**
+      * Translates the current image into the words written to LEDMatrix for each row,
+      * so that the render methods only have to copy precomputed values.
+      */
+    void compileFrame();
+
+    /**
+      * Called before each row is rendered. At the start of each refresh, presents any pending
+      * back buffer and compiles the next frame if it has changed.
+      */
+    void frameUpdate();
+
+    /**
+      * Exchanges the back buffer with the displayed image, and raises MICROBIT_DISPLAY_EVT_FRAME.
+      */
+    void presentBackBuffer();
+
     /**
       * Translates a bit mask to a bit mask suitable for the nrf PORT0 and PORT1.
       * Brightness has two levels on, or off.
@@ -190,6 +285,21 @@ class MicroBitDisplay : public MicroBitComponent
       */
     void updateScrollText();
 
+    /**
+      * Renders the given text into the scrolling strip, as it would appear scrolled across the display.
+      *
+      * @param s The text to render.
+      *
+      * @return MICROBIT_OK, or MICROBIT_NO_RESOURCES if the text is longer than MICROBIT_DISPLAY_SCROLL_STRIP_MAX allows.
+      */
+    int renderScrollStrip(ManagedString s);
+
+    /**
+      * Internal scrollText update method, used when the text has been pre-rendered.
+      * Copies the next window of the strip onto the display.
+      */
+    void updateScrollStrip();
+
     /**
       * Internal printText update method.
       * Paste the next character in the string.
@@ -208,6 +318,21 @@ class MicroBitDisplay : public MicroBitComponent
       */
     void updateAnimateImage();
 
+    /**
+      * Adds an item to the end of the playlist, and starts it if the display is free.
+      *
+      * @return MICROBIT_OK, MICROBIT_INVALID_PARAMETER or MICROBIT_NO_RESOURCES if the playlist is full.
+      */
+    int playlistAdd(uint8_t type, ManagedString text, MicroBitImage image, int delay, int stride);
+
+    /**
+      * Starts the next item in the playlist, if there is one. Must be called with interrupts disabled
+      * or from interrupt context, when no animation is running.
+      *
+      * @return MICROBIT_OK if an item was started, or MICROBIT_NO_DATA if the playlist is empty.
+      */
+    int playlistNext();
+
     /**
      * Broadcasts an event onto the defult EventModel indicating that the
      * current animation has completed.
@@ -506,6 +631,89 @@ public:
       */
     int animate(MicroBitImage image, int delay, int stride, int startingPosition = MICROBIT_DISPLAY_ANIMATE_DEFAULT_POS, int autoClear = MICROBIT_DISPLAY_DEFAULT_AUTOCLEAR);
 
+    /**
+      * Adds an image to the display's playlist, to be shown for the given time.
+      * Items in the playlist are displayed one after another, straight from the display's
+      * periodic update, without waking any fibers between them. MICROBIT_DISPLAY_EVT_ANIMATION_COMPLETE
+      * is raised once the playlist is empty.
+      *
+      * @param i The image to display.
+      *
+      * @param delay The time to display the image for, in milliseconds.
+      *
+      * @return MICROBIT_OK, MICROBIT_INVALID_PARAMETER or MICROBIT_NO_RESOURCES if the playlist is full.
+      *
+      * @code
+      * MicroBitImage heart("0,255,0,255,0\n255,255,255,255,255\n255,255,255,255,255\n0,255,255,255,0\n0,0,255,0,0\n");
+      * display.playlistPrint(heart, 500);
+      * display.playlistScroll("hello");
+      * @endcode
+      */
+    int playlistPrint(MicroBitImage i, int delay);
+
+    /**
+      * Adds text to the display's playlist, to be scrolled from right to left.
+      *
+      * @param s The string to display.
+      *
+      * @param delay The time to delay between characters, in milliseconds. Defaults
+      *              to: MICROBIT_DEFAULT_SCROLL_SPEED.
+      *
+      * @return MICROBIT_OK, MICROBIT_INVALID_PARAMETER or MICROBIT_NO_RESOURCES if the playlist is full.
+      *
+      * @code
+      * display.playlistScroll("abc123",100);
+      * @endcode
+      */
+    int playlistScroll(ManagedString s, int delay = MICROBIT_DEFAULT_SCROLL_SPEED);
+
+    /**
+      * Adds an image to the display's playlist, to be scrolled from right to left.
+      *
+      * @param image The image to display.
+      *
+      * @param delay The time between updates, in milliseconds. Defaults
+      *              to: MICROBIT_DEFAULT_SCROLL_SPEED.
+      *
+      * @param stride The number of pixels to shift by in each update. Defaults to MICROBIT_DEFAULT_SCROLL_STRIDE.
+      *
+      * @return MICROBIT_OK, MICROBIT_INVALID_PARAMETER or MICROBIT_NO_RESOURCES if the playlist is full.
+      *
+      * @code
+      * MicrobitImage i("1,1,1,1,1\n1,1,1,1,1\n");
+      * display.playlistScroll(i,100,1);
+      * @endcode
+      */
+    int playlistScroll(MicroBitImage image, int delay = MICROBIT_DEFAULT_SCROLL_SPEED, int stride = MICROBIT_DEFAULT_SCROLL_STRIDE);
+
+    /**
+      * Adds an image strip to the display's playlist, to be animated with the given stride,
+      * finishing on its last frame.
+      *
+      * @param image The image to display.
+      *
+      * @param delay The time to delay between each update of the display, in milliseconds.
+      *
+      * @param stride The number of pixels to shift by in each update.
+      *
+      * @return MICROBIT_OK, MICROBIT_INVALID_PARAMETER or MICROBIT_NO_RESOURCES if the playlist is full.
+      *
+      * @code
+      * const int heart_w = 10;
+      * const int heart_h = 5;
+      * const uint8_t heart[] = { 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, };
+      *
+      * MicroBitImage i(heart_w,heart_h,heart);
+      * display.playlistAnimate(i,100,5);
+      * @endcode
+      */
+    int playlistAnimate(MicroBitImage image, int delay, int stride);
+
+    /**
+      * Removes any items waiting in the display's playlist. The current animation is unaffected.
+      */
+    void playlistClear();
+
     /**
       * Configures the brightness of the display.
       *
@@ -538,6 +746,29 @@ public:
       */
     int getDisplayMode();
 
+    /**
+      * Selects how scrolling text is laid out.
+      *
+      * In proportional mode each character is only as wide as its glyph, with a narrow gap for spaces,
+      * so messages take fewer frames to scroll. Otherwise every character takes a full font width.
+      * Takes effect from the next call to scroll().
+      *
+      * @param enabled true to lay out text proportionally, false for fixed width characters.
+      *
+      * @code
+      * display.setProportionalText(true);
+      * display.scroll("Hello world!"); // scrolls in fewer frames
+      * @endcode
+      */
+    void setProportionalText(bool enabled);
+
+    /**
+      * Determines if scrolling text is laid out proportionally.
+      *
+      * @return true if proportional layout is in use, false for fixed width characters.
+      */
+    bool isProportionalText();
+
     /**
       * Fetches the current brightness of this display.
       *
@@ -594,6 +825,64 @@ public:
       */
     void clear();
 
+    /**
+      * Retrieves the back buffer, for applications that wish to draw complete frames without tearing.
+      * The buffer is created on first use, and is the same size as the displayed image. It is created
+      * afresh if the displayed image has since been replaced with one of a different size.
+      *
+      * Draw into the back buffer, then call swap() or swapAsync() to show it. The back buffer
+      * should not be modified again until the swap has completed. A swap exchanges the back buffer
+      * with the displayed image, so afterwards the back buffer holds the frame that was replaced.
+      *
+      * @return a reference to the back buffer. Keep the reference rather than copying it, as writing
+      *         to a copy would give the copy its own bitmap, leaving the back buffer unchanged.
+      *
+      * @code
+      * MicroBitImage &frame = display.getBackBuffer();
+      * frame.setPixelValue(2, 2, 255);
+      * display.swap();
+      * @endcode
+      */
+    MicroBitImage& getBackBuffer();
+
+    /**
+      * Requests that the back buffer is shown. The displayed image is updated from the back buffer
+      * at the start of the next refresh, so no frame is ever shown half old and half new.
+      * Returns immediately. MICROBIT_DISPLAY_EVT_FRAME is raised once the new frame has been taken.
+      *
+      * @return MICROBIT_OK, or MICROBIT_NO_DATA if the back buffer has not been created with getBackBuffer(),
+      *         or no longer matches the size of the displayed image.
+      *
+      * @code
+      * display.swapAsync();
+      * fiber_wait_for_event(MICROBIT_ID_DISPLAY, MICROBIT_DISPLAY_EVT_FRAME);
+      * @endcode
+      */
+    int swapAsync();
+
+    /**
+      * Requests that the back buffer is shown, and blocks the calling fiber until it has been taken
+      * at the start of the next refresh. Calling this in a loop runs an animation in step with the display.
+      *
+      * @return MICROBIT_OK, or MICROBIT_NO_DATA if the back buffer has not been created with getBackBuffer(),
+      *         or no longer matches the size of the displayed image.
+      *
+      * @code
+      * int x = 0;
+      *
+      * while(1)
+      * {
+      *     MicroBitImage &frame = display.getBackBuffer();
+      *     frame.clear();
+      *     frame.setPixelValue(x, 2, 255);
+      *     display.swap();
+      *
+      *     x = (x + 1) % 5;
+      * }
+      * @endcode
+      */
+    int swap();
+
     /**
       * Updates the font that will be used for display operations.
 	  *
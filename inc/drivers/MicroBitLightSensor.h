@@ -31,6 +31,7 @@ DEALINGS IN THE SOFTWARE.
 #include "MicroBitComponent.h"
 #include "EventModel.h"
 #include "MicroBitMatrixMaps.h"
+#include "MicroBitSystemTimer.h"
 
 #define MICROBIT_LIGHT_SENSOR_CHAN_NUM      3
 #define MICROBIT_LIGHT_SENSOR_AN_SET_TIME   4000
@@ -53,8 +54,8 @@ class MicroBitLightSensor
     //holds the current channel (also used to index the results array)
     uint8_t chan;
 
-    //a Timeout which triggers our analogReady() call
-    Timeout analogTrigger;
+    //a timer event which triggers our analogReady() call
+    MicroBitSystemTimerEvent analogTrigger;
 
     //a pointer the currently sensed pin, represented as an AnalogIn
     AnalogIn* sensePin;
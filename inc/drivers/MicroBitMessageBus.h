@@ -74,6 +74,8 @@ class MicroBitMessageBus : public EventModel, public MicroBitComponent
 	  *
 	  * @param evt The event to send.
       *
+      * @return MICROBIT_OK on success, or MICROBIT_NO_RESOURCES if the event had to be dropped as the queue is full.
+      *
       * @code
       * MicroBitMessageBus bus;
       *
@@ -159,8 +161,10 @@ class MicroBitMessageBus : public EventModel, public MicroBitComponent
       * Add the given event at the tail of our queue.
       *
       * @param The event to queue.
+      *
+      * @return MICROBIT_OK on success, or MICROBIT_NO_RESOURCES if the event was dropped.
       */
-    void queueEvent(MicroBitEvent &evt);
+    int queueEvent(MicroBitEvent &evt);
 
     /**
       * Extract the next event from the front of the event queue (if present).
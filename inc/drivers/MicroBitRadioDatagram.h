@@ -111,6 +111,27 @@ class MicroBitRadioDatagram
       */
     int send(PacketBuffer data);
 
+    /**
+      * Transmits the contents of several buffers onto the broadcast radio as a single packet,
+      * such as a protocol header followed by a payload, without first joining them together.
+      *
+      * This is a synchronous call that will wait until the transmission of the packet
+      * has completed before returning.
+      *
+      * @param buffers The buffers to transmit, in order.
+      *
+      * @param count The number of buffers.
+      *
+      * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the buffers are invalid,
+      *         or their total length is greater than `MICROBIT_RADIO_MAX_PACKET_SIZE`.
+      *
+      * @code
+      * PacketBuffer parts[] = { header, payload };
+      * uBit.radio.datagram.send(parts, 2);
+      * @endcode
+      */
+    int send(PacketBuffer *buffers, int count);
+
     /**
       * Transmits the given string onto the broadcast radio.
       *
@@ -195,6 +195,18 @@ class MicroBitSerial : public RawSerial
       */
     void circularCopy(uint8_t *circularBuff, uint8_t circularBuffSize, uint8_t *linearBuff, uint16_t tailPosition, uint16_t headPosition);
 
+    /**
+      * An internal method that finds the first delimeter in the rxBuff, waiting for one as
+      * dictated by the given mode. The caller must hold the rx lock.
+      *
+      * @param delimeters a ManagedString containing a sequence of delimeter characters
+      *
+      * @param mode the selected mode, as for readUntil().
+      *
+      * @return the number of characters that precede the delimeter, or -1 if none was found.
+      */
+    int scanUntil(ManagedString delimeters, MicroBitSerialMode mode);
+
     public:
 
     /**
@@ -299,6 +311,30 @@ class MicroBitSerial : public RawSerial
       */
     int send(uint8_t *buffer, int bufferLen, MicroBitSerialMode mode = MICROBIT_DEFAULT_SERIAL_MODE);
 
+    /**
+      * Sends the contents of several buffers over the serial line, one after another,
+      * such as a protocol header followed by a payload, without first joining them together.
+      * No other fiber can send in between them.
+      *
+      * @param buffers the buffers to send, in order.
+      *
+      * @param count the number of buffers.
+      *
+      * @param mode the selected mode, one of: ASYNC, SYNC_SPINWAIT, SYNC_SLEEP, as for send() above.
+      *             In ASYNC mode, sending stops at the first buffer that does not fit in the txBuff.
+      *             Defaults to SYNC_SLEEP.
+      *
+      * @return the total number of bytes written, MICROBIT_SERIAL_IN_USE if another fiber
+      *         is using the serial instance for transmission, or MICROBIT_INVALID_PARAMETER
+      *         if buffers is invalid, or the given count is <= 0.
+      *
+      * @code
+      * PacketBuffer parts[] = { header, payload };
+      * serial.send(parts, 2);
+      * @endcode
+      */
+    int send(PacketBuffer *buffers, int count, MicroBitSerialMode mode = MICROBIT_DEFAULT_SERIAL_MODE);
+
     /**
       * Reads a single character from the rxBuff
       *
@@ -410,6 +446,35 @@ class MicroBitSerial : public RawSerial
       */
     ManagedString readUntil(ManagedString delimeters, MicroBitSerialMode mode = MICROBIT_DEFAULT_SERIAL_MODE);
 
+    /**
+      * Reads characters until a character matches one of the given delimeters, into a buffer
+      * supplied by the caller. No memory is allocated, so this pairs well with StringView for
+      * parsing received commands.
+      *
+      * Characters beyond the end of the buffer are discarded, up to and including the delimeter.
+      *
+      * @param buffer a pointer to a memory location where the characters should be placed.
+      *
+      * @param bufferLen the size of the buffer.
+      *
+      * @param delimeters a ManagedString containing a sequence of delimeter characters e.g. ManagedString("\r\n")
+      *
+      * @param mode the selected mode, one of: ASYNC, SYNC_SPINWAIT, SYNC_SLEEP, as for readUntil() above.
+      *             Defaults to SYNC_SLEEP.
+      *
+      * @return the number of characters placed in the buffer, which may be 0 if no delimeter was found,
+      *         or MICROBIT_SERIAL_IN_USE if another fiber is currently using this instance for reception.
+      *
+      * @code
+      * char line[32];
+      * int n = serial.readUntil((uint8_t *)line, sizeof(line), "\n");
+      * StringView command(line, n);
+      * @endcode
+      *
+      * @note delimeters are matched on a per byte basis.
+      */
+    int readUntil(uint8_t *buffer, int bufferLen, ManagedString delimeters, MicroBitSerialMode mode = MICROBIT_DEFAULT_SERIAL_MODE);
+
     /**
       * A wrapper around the inherited method "baud" so we can trap the baud rate
       * as it changes and restore it if redirect() is called.
@@ -15,6 +15,10 @@
     #define MICROBIT_NESTED_HEAP_SIZE YOTTA_CFG_MICROBIT_DAL_NESTED_HEAP_PROPORTION
 #endif
 
+#ifdef YOTTA_CFG_MICROBIT_DAL_HEAP_IRQ_SIZE
+    #define MICROBIT_HEAP_IRQ_SIZE YOTTA_CFG_MICROBIT_DAL_HEAP_IRQ_SIZE
+#endif
+
 #ifdef YOTTA_CFG_MICROBIT_DAL_REUSE_SD
     #define MICROBIT_HEAP_REUSE_SD YOTTA_CFG_MICROBIT_DAL_REUSE_SD
 #endif
@@ -27,10 +31,18 @@
     #define SYSTEM_TICK_PERIOD_MS YOTTA_CFG_MICROBIT_DAL_SYSTEM_TICK_PERIOD
 #endif
 
+#ifdef YOTTA_CFG_MICROBIT_DAL_BUTTON_SAMPLE_PERIOD
+    #define MICROBIT_BUTTON_SAMPLE_PERIOD YOTTA_CFG_MICROBIT_DAL_BUTTON_SAMPLE_PERIOD
+#endif
+
 #ifdef YOTTA_CFG_MICROBIT_DAL_SYSTEM_COMPONENTS
     #define MICROBIT_SYSTEM_COMPONENTS YOTTA_CFG_MICROBIT_DAL_SYSTEM_COMPONENTS
 #endif
 
+#ifdef YOTTA_CFG_MICROBIT_DAL_SYSTEM_TICK_PROFILING
+    #define MICROBIT_SYSTEM_TICK_PROFILING YOTTA_CFG_MICROBIT_DAL_SYSTEM_TICK_PROFILING
+#endif
+
 #ifdef YOTTA_CFG_MICROBIT_DAL_IDLE_COMPONENTS
     #define MICROBIT_IDLE_COMPONENTS YOTTA_CFG_MICROBIT_DAL_IDLE_COMPONENTS
 #endif
@@ -55,6 +67,10 @@
     #define MICROBIT_DISPLAY_MAXIMUM_BRIGHTNESS YOTTA_CFG_MICROBIT_DAL_MAX_DISPLAY_BRIGHTNESS
 #endif
 
+#ifdef YOTTA_CFG_MICROBIT_DAL_DISPLAY_GAMMA_CORRECTION
+    #define MICROBIT_DISPLAY_GAMMA_CORRECTION YOTTA_CFG_MICROBIT_DAL_DISPLAY_GAMMA_CORRECTION
+#endif
+
 #ifdef YOTTA_CFG_MICROBIT_DAL_DISPLAY_SCROLL_SPEED
     #define MICROBIT_DEFAULT_SCROLL_SPEED YOTTA_CFG_MICROBIT_DAL_DISPLAY_SCROLL_SPEED
 #endif
@@ -63,6 +79,22 @@
     #define MICROBIT_DEFAULT_SCROLL_STRIDE YOTTA_CFG_MICROBIT_DAL_DISPLAY_SCROLL_STRIDE
 #endif
 
+#ifdef YOTTA_CFG_MICROBIT_DAL_DISPLAY_SCROLL_STRIP_MAX
+    #define MICROBIT_DISPLAY_SCROLL_STRIP_MAX YOTTA_CFG_MICROBIT_DAL_DISPLAY_SCROLL_STRIP_MAX
+#endif
+
+#ifdef YOTTA_CFG_MICROBIT_DAL_DISPLAY_PROPORTIONAL_TEXT
+    #define MICROBIT_DISPLAY_PROPORTIONAL_TEXT YOTTA_CFG_MICROBIT_DAL_DISPLAY_PROPORTIONAL_TEXT
+#endif
+
+#ifdef YOTTA_CFG_MICROBIT_DAL_FONT_GLYPH_CACHE_SIZE
+    #define MICROBIT_FONT_GLYPH_CACHE_SIZE YOTTA_CFG_MICROBIT_DAL_FONT_GLYPH_CACHE_SIZE
+#endif
+
+#ifdef YOTTA_CFG_MICROBIT_DAL_DISPLAY_PLAYLIST_SIZE
+    #define MICROBIT_DISPLAY_PLAYLIST_SIZE YOTTA_CFG_MICROBIT_DAL_DISPLAY_PLAYLIST_SIZE
+#endif
+
 #ifdef YOTTA_CFG_MICROBIT_DAL_DISPLAY_PRINT_SPEED
     #define MICROBIT_DEFAULT_PRINT_SPEED YOTTA_CFG_MICROBIT_DAL_DISPLAY_PRINT_SPEED
 #endif
@@ -79,6 +111,46 @@
     #define MICROBIT_PANIC_HEAP_FULL YOTTA_CFG_MICROBIT_DAL_PANIC_ON_HEAP_FULL
 #endif
 
+#ifdef YOTTA_CFG_MICROBIT_DAL_MOVE_SEMANTICS
+    #define MICROBIT_MOVE_SEMANTICS YOTTA_CFG_MICROBIT_DAL_MOVE_SEMANTICS
+#endif
+
+#ifdef YOTTA_CFG_MICROBIT_DAL_STRING_INTERN_TABLE_SIZE
+    #define MICROBIT_STRING_INTERN_TABLE_SIZE YOTTA_CFG_MICROBIT_DAL_STRING_INTERN_TABLE_SIZE
+#endif
+
+#ifdef YOTTA_CFG_MICROBIT_DAL_STRING_INLINE_SIZE
+    #define MICROBIT_STRING_INLINE_SIZE YOTTA_CFG_MICROBIT_DAL_STRING_INLINE_SIZE
+#endif
+
+#ifdef YOTTA_CFG_MICROBIT_DAL_POOL_ENABLED
+    #define MICROBIT_POOL_ENABLED YOTTA_CFG_MICROBIT_DAL_POOL_ENABLED
+#endif
+
+#ifdef YOTTA_CFG_MICROBIT_DAL_POOL_SMALL_SIZE
+    #define MICROBIT_POOL_SMALL_SIZE YOTTA_CFG_MICROBIT_DAL_POOL_SMALL_SIZE
+#endif
+
+#ifdef YOTTA_CFG_MICROBIT_DAL_POOL_SMALL_BLOCKS
+    #define MICROBIT_POOL_SMALL_BLOCKS YOTTA_CFG_MICROBIT_DAL_POOL_SMALL_BLOCKS
+#endif
+
+#ifdef YOTTA_CFG_MICROBIT_DAL_POOL_MEDIUM_SIZE
+    #define MICROBIT_POOL_MEDIUM_SIZE YOTTA_CFG_MICROBIT_DAL_POOL_MEDIUM_SIZE
+#endif
+
+#ifdef YOTTA_CFG_MICROBIT_DAL_POOL_MEDIUM_BLOCKS
+    #define MICROBIT_POOL_MEDIUM_BLOCKS YOTTA_CFG_MICROBIT_DAL_POOL_MEDIUM_BLOCKS
+#endif
+
+#ifdef YOTTA_CFG_MICROBIT_DAL_POOL_LARGE_SIZE
+    #define MICROBIT_POOL_LARGE_SIZE YOTTA_CFG_MICROBIT_DAL_POOL_LARGE_SIZE
+#endif
+
+#ifdef YOTTA_CFG_MICROBIT_DAL_POOL_LARGE_BLOCKS
+    #define MICROBIT_POOL_LARGE_BLOCKS YOTTA_CFG_MICROBIT_DAL_POOL_LARGE_BLOCKS
+#endif
+
 #ifdef YOTTA_CFG_MICROBIT_DAL_DEBUG
     #define MICROBIT_DBG YOTTA_CFG_MICROBIT_DAL_DEBUG
 #endif
@@ -30,6 +30,9 @@ DEALINGS IN THE SOFTWARE.
 #include "RefCounted.h"
 #include "PacketBuffer.h"
 
+// The longest string a ManagedString can hold inline, without a StringData.
+#define MANAGED_STRING_INLINE_LENGTH    (MICROBIT_STRING_INLINE_SIZE - 2)
+
 struct StringData : RefCounted
 {
     uint16_t len;
@@ -62,7 +65,31 @@ class ManagedString
     // When referece count is 0xffff, then it's read only and should not be counted.
     // Otherwise the block was malloc()ed.
     // We control access to this to proide immutability and reference counting.
-    StringData *ptr;
+    //
+    // Strings of up to MANAGED_STRING_INLINE_LENGTH characters are instead held in the object itself,
+    // with no StringData and no reference count. StringData is always word aligned, so the lowest bit
+    // of ptr is clear, and as our targets are little endian that bit lies in inlineData[0].
+    // An inline string sets it, keeping its length in the upper seven bits and its NULL terminated
+    // characters from inlineData[1].
+    union
+    {
+        StringData *ptr;
+        char inlineData[MICROBIT_STRING_INLINE_SIZE];
+    };
+
+    // StringView holds a reference to our StringData, to keep the characters it refers to alive.
+    friend class StringView;
+
+    // ManagedStringBuilder writes the characters of short strings directly into their storage.
+    friend class ManagedStringBuilder;
+
+    /**
+      * Determines if this string is held inline, rather than in a StringData.
+      */
+    bool isInline() const
+    {
+        return inlineData[0] & 1;
+    }
 
     public:
 
@@ -81,6 +108,7 @@ class ManagedString
 
     /**
       * Get current ptr, do not decr() it, and set the current instance to empty string.
+      * If the string is held inline, a new StringData is created to hold it.
       *
       * This is to be used by specialized runtimes which pass StringData around.
       */
@@ -162,7 +190,8 @@ class ManagedString
       * Copy constructor.
       * Makes a new ManagedString identical to the one supplied.
       *
-      * Shares the character buffer and reference count with the supplied ManagedString.
+      * Shares the character buffer and reference count with the supplied ManagedString,
+      * or copies the characters if they are held inline.
       *
       * @param s The ManagedString to copy.
       *
@@ -215,6 +244,26 @@ class ManagedString
       */
     ManagedString& operator = (const ManagedString& s);
 
+#if CONFIG_ENABLED(MICROBIT_MOVE_SEMANTICS)
+    /**
+      * Move constructor.
+      * Takes over the data of a ManagedString that is about to be destroyed, without
+      * changing its reference count.
+      *
+      * @param s The ManagedString to move from. It is left as the empty string.
+      */
+    ManagedString(ManagedString &&s);
+
+    /**
+      * Move assign operation.
+      * Releases our current data, and takes over that of a ManagedString that is about to
+      * be destroyed, without changing its reference count.
+      *
+      * @param s The ManagedString to move from. It is left as the empty string.
+      */
+    ManagedString& operator = (ManagedString &&s);
+#endif
+
     /**
       * Equality operation.
       *
@@ -341,7 +390,7 @@ class ManagedString
       */
     const char *toCharArray() const
     {
-        return ptr->data;
+        return isInline() ? inlineData + 1 : ptr->data;
     }
 
     /**
@@ -358,9 +407,41 @@ class ManagedString
       */
     int16_t length() const
     {
-        return ptr->len;
+        return isInline() ? (uint8_t)inlineData[0] >> 1 : ptr->len;
     }
 
+    /**
+      * Computes a 16 bit hash of the characters of this ManagedString.
+      *
+      * @return the hash of the string. Equal strings always have equal hashes.
+      */
+    uint16_t hash() const;
+
+    /**
+      * Returns the canonical instance of this string from the intern table, adding this
+      * one if it is not already there.
+      *
+      * Interned strings with the same characters share a single StringData, so comparing
+      * them for equality is a pointer comparison, and repeated copies cost no memory.
+      * Strings added to the table stay in memory for the life of the program, so intern
+      * only long lived strings such as keys, names and delimiter sets.
+      *
+      * Strings of up to MANAGED_STRING_INLINE_LENGTH characters are held inline rather than in a
+      * StringData, so they are returned unchanged and are never added to the table. They already
+      * cost no heap, and are always compared by value.
+      *
+      * @return the canonical instance of this string, or this string itself if it is held inline
+      *         or the table is full.
+      *
+      * @code
+      * static ManagedString key = ManagedString("configuration").intern();
+      *
+      * if (ManagedString(name).intern() == key) // compares pointers, as the key is too long to be inline
+      *     ...
+      * @endcode
+      */
+    ManagedString intern() const;
+
     /**
       * Empty String constant
       */
@@ -382,6 +463,25 @@ class ManagedString
       */
     void initString(const char *str);
 
+    /**
+      * Internal constructor helper.
+      *
+      * Sets up storage for a string of the given length, inline if it is short enough and
+      * in a new StringData otherwise, and NULL terminates it. Any current contents are
+      * discarded without being released.
+      *
+      * @param len The length of the string, which must be greater than zero.
+      *
+      * @return a pointer to where the characters of the string should be written.
+      */
+    char *initBuffer(int len);
+
+    /**
+      * Provides a StringData holding the characters of this string, with a new reference for the caller.
+      * This is our own StringData, or a copy of the characters if we are held inline.
+      */
+    StringData *toStringData() const;
+
     /**
       * Private Constructor.
       *
@@ -0,0 +1,190 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 British Broadcasting Corporation.
+This software is provided by Lancaster University by arrangement with the BBC.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef MANAGED_STRING_BUILDER_H
+#define MANAGED_STRING_BUILDER_H
+
+#include "MicroBitConfig.h"
+#include "ManagedString.h"
+#include "PacketBuffer.h"
+
+// Size of the first buffer allocated by a ManagedStringBuilder, in characters.
+#define MANAGED_STRING_BUILDER_DEFAULT_CAPACITY     16
+
+/**
+  * Class definition for a ManagedStringBuilder.
+  *
+  * Builds up a ManagedString from many pieces using a single growable buffer, rather than
+  * allocating and copying a new string for every concatenation. The buffer grows geometrically,
+  * so appending n characters costs O(n) overall, and is handed over to the resulting
+  * ManagedString without a further copy where it is a good fit.
+  *
+  * @code
+  * ManagedStringBuilder b;
+  * b.append("x=").append(x).append(",y=").append(y);
+  * ManagedString s = b.toManagedString();
+  * @endcode
+  */
+class ManagedStringBuilder
+{
+    StringData *buffer;     // The string under construction, in the same form as a ManagedString payload.
+    uint16_t capacity;      // The number of characters buffer can hold, excluding the terminator.
+
+    /**
+      * Ensures the buffer has room for at least the given number of further characters.
+      *
+      * @return MICROBIT_OK, or MICROBIT_NO_RESOURCES if the string would exceed its maximum length.
+      */
+    int grow(int n);
+
+    // Builders own their buffer outright, so cannot be copied.
+    ManagedStringBuilder(const ManagedStringBuilder &);
+    ManagedStringBuilder& operator = (const ManagedStringBuilder &);
+
+    public:
+
+    /**
+      * Constructor.
+      * Creates an empty builder. No memory is allocated until the first append.
+      *
+      * @param capacity The number of characters to allocate room for initially. Defaults to MANAGED_STRING_BUILDER_DEFAULT_CAPACITY.
+      */
+    ManagedStringBuilder(int capacity = MANAGED_STRING_BUILDER_DEFAULT_CAPACITY);
+
+    /**
+      * Destructor.
+      *
+      * Frees the buffer, if it has not been handed to a ManagedString.
+      */
+    ~ManagedStringBuilder();
+
+    /**
+      * Ensures the builder can hold at least the given number of characters without reallocating.
+      *
+      * @param capacity The number of characters to reserve room for.
+      *
+      * @return MICROBIT_OK, or MICROBIT_NO_RESOURCES if the capacity cannot be provided.
+      */
+    int reserve(int capacity);
+
+    /**
+      * Appends a ManagedString.
+      *
+      * @param s The string to append.
+      *
+      * @return A reference to this builder, so appends can be chained.
+      */
+    ManagedStringBuilder& append(const ManagedString &s);
+
+    /**
+      * Appends a NULL terminated character array.
+      *
+      * @param s The characters to append.
+      *
+      * @return A reference to this builder, so appends can be chained.
+      */
+    ManagedStringBuilder& append(const char *s);
+
+    /**
+      * Appends the given number of characters from a buffer.
+      *
+      * @param s The characters to append.
+      *
+      * @param length The number of characters to append.
+      *
+      * @return A reference to this builder, so appends can be chained.
+      */
+    ManagedStringBuilder& append(const char *s, int length);
+
+    /**
+      * Appends a single character.
+      *
+      * @param c The character to append.
+      *
+      * @return A reference to this builder, so appends can be chained.
+      */
+    ManagedStringBuilder& append(char c);
+
+    /**
+      * Appends the decimal representation of an integer.
+      *
+      * @param value The integer to append.
+      *
+      * @return A reference to this builder, so appends can be chained.
+      */
+    ManagedStringBuilder& append(int value);
+
+    /**
+      * Appends the decimal representation of a fixed point number.
+      *
+      * @param value The number to append, scaled up by 10 to the power of places.
+      *
+      * @param places The number of digits after the decimal point, from 0 to 9.
+      *
+      * @return A reference to this builder, so appends can be chained.
+      *
+      * @code
+      * b.append("temp=").appendFixed(tenths, 1);
+      * @endcode
+      */
+    ManagedStringBuilder& appendFixed(int value, int places);
+
+    /**
+      * Appends the contents of a PacketBuffer.
+      *
+      * @param buffer The bytes to append.
+      *
+      * @return A reference to this builder, so appends can be chained.
+      */
+    ManagedStringBuilder& append(PacketBuffer buffer);
+
+    /**
+      * Gets the number of characters appended so far.
+      *
+      * @return The length of the string being built.
+      */
+    int length() const
+    {
+        return buffer ? buffer->len : 0;
+    }
+
+    /**
+      * Discards everything appended so far, keeping the buffer for reuse.
+      */
+    void clear();
+
+    /**
+      * Finishes the string, and returns it as a ManagedString. The builder is left empty.
+      *
+      * If the buffer is reasonably full it becomes the payload of the ManagedString directly,
+      * and the builder allocates a fresh one on its next append. Otherwise the contents are
+      * copied into an exactly sized string, and the buffer is kept for reuse.
+      *
+      * @return The string that has been built.
+      */
+    ManagedString toManagedString();
+};
+
+#endif
@@ -92,6 +92,24 @@ public:
       */
     ManagedType<T>& operator = (const ManagedType<T>&i);
 
+#if CONFIG_ENABLED(MICROBIT_MOVE_SEMANTICS)
+    /**
+      * Move constructor for the managed type, given a class space T.
+      * Takes over the object and reference count of an instance that is about to be destroyed.
+      *
+      * @param t the managed type instance to move from. It is left holding nothing.
+      */
+    ManagedType(ManagedType<T> &&t);
+
+    /**
+      * Move-assign member function for the managed type, given a class space T.
+      * Exchanges our object and reference count with those of an instance that is about to be destroyed.
+      *
+      * @param t the managed type instance to move from. It is left holding our previous object, which it releases when destroyed.
+      */
+    ManagedType<T>& operator = (ManagedType<T> &&t);
+#endif
+
     /**
       * Returns the references to this ManagedType.
       *
@@ -199,7 +217,9 @@ ManagedType<T>::ManagedType(const ManagedType<T> &t)
 {
     this->object = t.object;
     this->ref = t.ref;
-    (*ref)++;
+
+    if (ref)
+        (*ref)++;
 }
 
 /**
@@ -208,6 +228,10 @@ ManagedType<T>::ManagedType(const ManagedType<T> &t)
 template<typename T>
 ManagedType<T>::~ManagedType()
 {
+    // Special case - our contents have been moved to another instance.
+    if (ref == NULL)
+        return;
+
     // Special case - we were created using a default constructor, and never assigned a value.
     if (*ref == 0)
     {
@@ -239,8 +263,14 @@ ManagedType<T>& ManagedType<T>::operator = (const ManagedType<T>&t)
     if (this == &t)
         return *this;
 
+    // Special case - our contents have been moved to another instance.
+    if (ref == NULL)
+    {
+        // Nothing to release.
+    }
+
     // Special case - we were created using a default constructor, and never assigned a value.
-    if (*ref == 0)
+    else if (*ref == 0)
     {
         // Simply destroy our reference counter, as we're about to adopt another.
         free(ref);
@@ -255,7 +285,8 @@ ManagedType<T>& ManagedType<T>::operator = (const ManagedType<T>&t)
     object = t.object;
     ref = t.ref;
 
-    (*ref)++;
+    if (ref)
+        (*ref)++;
 
     return *this;
 }
@@ -274,6 +305,49 @@ ManagedType<T>& ManagedType<T>::operator = (const ManagedType<T>&t)
 template<typename T>
 int ManagedType<T>::getReferences()
 {
-    return (*ref);
+    return ref ? (*ref) : 0;
+}
+
+#if CONFIG_ENABLED(MICROBIT_MOVE_SEMANTICS)
+/**
+  * Move constructor for the managed type, given a class space T.
+  * Takes over the object and reference count of an instance that is about to be destroyed.
+  *
+  * @param t the managed type instance to move from. It is left holding nothing.
+  */
+template<typename T>
+ManagedType<T>::ManagedType(ManagedType<T> &&t)
+{
+    object = t.object;
+    ref = t.ref;
+
+    t.object = NULL;
+    t.ref = NULL;
 }
+
+/**
+  * Move-assign member function for the managed type, given a class space T.
+  * Exchanges our object and reference count with those of an instance that is about to be destroyed.
+  *
+  * @param t the managed type instance to move from. It is left holding our previous object, which it releases when destroyed.
+  */
+template<typename T>
+ManagedType<T>& ManagedType<T>::operator = (ManagedType<T> &&t)
+{
+    if (this == &t)
+        return *this;
+
+    // Hand our current contents to t, which releases them when it is destroyed.
+    T *o = object;
+    int *r = ref;
+
+    object = t.object;
+    ref = t.ref;
+
+    t.object = o;
+    t.ref = r;
+
+    return *this;
+}
+#endif
 #endif
@@ -36,7 +36,9 @@ DEALINGS IN THE SOFTWARE.
 enum MicroBitEventLaunchMode
 {
     CREATE_ONLY,
-    CREATE_AND_FIRE
+    CREATE_AND_FIRE,
+    CREATE_ONLY_NO_TIMESTAMP,
+    CREATE_AND_FIRE_NO_TIMESTAMP
 };
 
 #define MICROBIT_EVENT_DEFAULT_LAUNCH_MODE     CREATE_AND_FIRE
@@ -52,7 +54,7 @@ class MicroBitEvent
 
     uint16_t source;         // ID of the MicroBit Component that generated the event e.g. MICROBIT_ID_BUTTON_A.
     uint16_t value;          // Component specific code indicating the cause of the event.
-    uint64_t timestamp;      // Time at which the event was generated. us since power on.
+    uint64_t timestamp;      // Time at which the event was generated. us since power on, or zero if not timestamped.
 
     /**
       * Constructor.
@@ -64,6 +66,8 @@ class MicroBitEvent
       * @param mode Optional definition of how the event should be processed after construction (if at all):
       *                 CREATE_ONLY: MicroBitEvent is initialised, and no further processing takes place.
       *                 CREATE_AND_FIRE: MicroBitEvent is initialised, and its event handlers are immediately fired (not suitable for use in interrupts!).
+      *                 CREATE_ONLY_NO_TIMESTAMP, CREATE_AND_FIRE_NO_TIMESTAMP: As above, but the timestamp is left as zero.
+      *                 This saves reading the system clock for events whose listeners never inspect it.
       *
       * @code
       * // Create and launch an event using the default configuration
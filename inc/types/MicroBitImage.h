@@ -38,6 +38,70 @@ struct ImageData : RefCounted
     uint8_t data[0];    // 2D array representing the bitmap image
 };
 
+/**
+  * Layout of an ImageData with a bitmap of a fixed size, so that an image can be written
+  * as a constant at compile time and kept in flash, rather than parsed and allocated at runtime.
+  *
+  * Use MICROBIT_IMAGE to declare one.
+  */
+template <int N>
+struct ImageLiteral
+{
+    uint16_t refCount;  // Always 0xffff, marking the data as read-only (see RefCounted)
+    uint16_t width;     // Width in pixels
+    uint16_t height;    // Height in pixels
+    uint8_t data[N];    // 2D array representing the bitmap image
+
+    /**
+      * Returns this literal as an ImageData, for use with MicroBitImage(ImageData *).
+      */
+    ImageData *getImageData() const
+    {
+        return (ImageData*)(void*)this;
+    }
+};
+
+/**
+  * Declares a MicroBitImage whose bitmap is built at compile time and held in flash.
+  * No parsing happens at startup, and no RAM is used for the bitmap until the image is
+  * modified, at which point it is copied as with any other shared image.
+  *
+  * Animation strips are declared the same way: make the width the total width of all frames
+  * side by side, list each row across every frame, and pass the frame width as the stride
+  * to MicroBitDisplay::animate().
+  *
+  * @param name The name of the MicroBitImage to declare.
+  *
+  * @param width The width of the image.
+  *
+  * @param height The height of the image.
+  *
+  * @param ... The pixel values, row by row. Any that are not given are 0.
+  *
+  * @code
+  * MICROBIT_IMAGE(heart, 5, 5,
+  *     0, 255, 0, 255, 0,
+  *     255, 255, 255, 255, 255,
+  *     255, 255, 255, 255, 255,
+  *     0, 255, 255, 255, 0,
+  *     0, 0, 255, 0, 0);
+  *
+  * uBit.display.print(heart);
+  * @endcode
+  *
+  * @note This is a variadic macro, which standard C++ only supports from C++11. GCC also accepts
+  *       variadic macros in its gnu++98 mode, which this module builds with. The macro is not
+  *       defined for other compilers running in C++98 mode.
+  */
+#if __cplusplus >= 201103L || defined(__GNUC__)
+#define MICROBIT_IMAGE(name, width, height, ...)                                                                            \
+    static const ImageLiteral<(width) * (height)> name##_literal __attribute__ ((aligned (4))) =                            \
+        { 0xffff, (width), (height), { __VA_ARGS__ } };                                                                     \
+    MicroBitImage name(name##_literal.getImageData())
+#endif
+
+class MicroBitMonoImage;
+
 /**
   * Class definition for a MicroBitImage.
   *
@@ -65,9 +129,19 @@ class MicroBitImage
       */
     void init_empty();
 
+    /**
+      * Ensures this instance holds the only reference to its bitmap, copying it if it is
+      * shared with another MicroBitImage or resides in flash.
+      */
+    void unshare();
+
     public:
     static MicroBitImage EmptyImage;    // Shared representation of a null image.
 
+    // Incremented on every call to getMutableBitmap(), by any image. Code that caches a rendering
+    // of an image (such as MicroBitDisplay) compares this against the value it last rendered at.
+    static volatile uint32_t writeCount;
+
     /**
       * Get current ptr, do not decr() it, and set the current instance to empty image.
       *
@@ -77,12 +151,55 @@ class MicroBitImage
 
     /**
       * Return a 2D array representing the bitmap image.
+      *
+      * The bitmap may be shared with other MicroBitImage instances, or reside in flash,
+      * so it should only be read. Use getMutableBitmap() to modify it.
+      */
+    const uint8_t *getBitmap() const
+    {
+        return ptr->data;
+    }
+
+    /**
+      * Return a 2D array representing the bitmap image, that can safely be modified.
+      *
+      * MicroBitImage is copy-on-write: if the bitmap is shared with another instance, or
+      * resides in flash, this instance first takes a private copy of it. The pointer
+      * remains valid until this instance is next assigned.
+      *
+      * @code
+      * MicroBitImage i("1,0,1\n0,1,0\n");
+      * MicroBitImage i2(i);
+      * i2.getMutableBitmap()[0] = 0; // i is unchanged
+      * @endcode
       */
-    uint8_t *getBitmap()
+    uint8_t *getMutableBitmap()
     {
+        unshare();
+        writeCount++;
         return ptr->data;
     }
 
+    /**
+      * Exchanges the bitmaps of this image and another, without copying any pixels, allocating
+      * or changing any reference counts. This makes it safe to call from interrupt context.
+      *
+      * @param image The image to exchange bitmaps with.
+      *
+      * @code
+      * MicroBitImage front(5,5);
+      * MicroBitImage back(5,5);
+      * back.setPixelValue(0,0,255);
+      * front.swap(back); // front now holds the pixel that was set.
+      * @endcode
+      */
+    void swap(MicroBitImage &image)
+    {
+        ImageData *p = ptr;
+        ptr = image.ptr;
+        image.ptr = p;
+    }
+
     /**
       * Constructor.
       * Create an image from a specially prepared constant array, with no copying. Will call ptr->incr().
@@ -110,12 +227,13 @@ class MicroBitImage
     /**
       * Copy Constructor.
       * Add ourselves as a reference to an existing MicroBitImage.
+      * The bitmap is shared, with no copying, until either image is modified.
       *
       * @param image The MicroBitImage to reference.
       *
       * @code
       * MicroBitImage i("0,1,0,1,0\n");
-      * MicroBitImage i2(i); //points to i
+      * MicroBitImage i2(i); //points to i, until one of them is changed
       * @endcode
       */
     MicroBitImage(const MicroBitImage &image);
@@ -195,6 +313,26 @@ class MicroBitImage
       */
     MicroBitImage& operator = (const MicroBitImage& i);
 
+#if CONFIG_ENABLED(MICROBIT_MOVE_SEMANTICS)
+    /**
+      * Move constructor.
+      * Takes over the data of a MicroBitImage that is about to be destroyed, without
+      * changing its reference count.
+      *
+      * @param i The MicroBitImage to move from. It is left as the empty image.
+      */
+    MicroBitImage(MicroBitImage &&i);
+
+    /**
+      * Move assign operation.
+      * Releases our current data, and takes over that of a MicroBitImage that is about to
+      * be destroyed, without changing its reference count.
+      *
+      * @param i The MicroBitImage to move from. It is left as the empty image.
+      */
+    MicroBitImage& operator = (MicroBitImage &&i);
+#endif
+
 
     /**
       * Equality operation.
@@ -307,6 +445,31 @@ class MicroBitImage
       */
     int paste(const MicroBitImage &image, int16_t x = 0, int16_t y = 0, uint8_t alpha = 0);
 
+    /**
+      * Pastes a given one bit per pixel bitmap at the given co-ordinates.
+      *
+      * Set pixels in the given image are written with the given value, clear pixels are written as 0.
+      *
+      * @param image The MicroBitMonoImage to paste.
+      *
+      * @param x The leftmost X co-ordinate in this image where the given image should be pasted. Defaults to 0.
+      *
+      * @param y The uppermost Y co-ordinate in this image where the given image should be pasted. Defaults to 0.
+      *
+      * @param alpha set to 1 if clear pixels in given image should be treated as transparent. Set to 0 otherwise.  Defaults to 0.
+      *
+      * @param value The brightness to write for set pixels. Defaults to 255.
+      *
+      * @return The number of pixels written.
+      *
+      * @code
+      * MicroBitMonoImage sprite(5,5);
+      * MicroBitImage i(5,5);
+      * i.paste(sprite, 0, 0, 1, 128);
+      * @endcode
+      */
+    int paste(const MicroBitMonoImage &image, int16_t x = 0, int16_t y = 0, uint8_t alpha = 0, uint8_t value = 255);
+
      /**
        * Prints a character to the display at the given location
        *
@@ -470,7 +633,10 @@ class MicroBitImage
     bool isReadOnly();
 
     /**
-      * Create a copy of the image bitmap. Used particularly, when isReadOnly() is true.
+      * Create a copy of the image bitmap.
+      *
+      * As MicroBitImage is copy-on-write, this is no longer needed before modifying a shared
+      * or read-only image; it simply forces the copy to happen now.
       *
       * @return an instance of MicroBitImage which can be modified independently of the current instance
       */
@@ -0,0 +1,160 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 British Broadcasting Corporation.
+This software is provided by Lancaster University by arrangement with the BBC.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef MICROBIT_IMAGE_ATLAS_H
+#define MICROBIT_IMAGE_ATLAS_H
+
+#include "mbed.h"
+#include "MicroBitConfig.h"
+#include "MicroBitImage.h"
+
+/**
+  * Header of a compressed image atlas.
+  *
+  * The header is followed by a table of frame offsets, then the compressed frames themselves.
+  * Each frame is a run length encoded stream of pixels, row by row, made of packets:
+  *
+  * 0x00..0x7f n: the next n+1 bytes are literal pixel values.
+  * 0x80..0xff n: the next byte is repeated (n & 0x7f)+1 times.
+  *
+  * Packets may span rows.
+  */
+struct ImageAtlasData
+{
+    uint16_t width;         // Width of each frame in pixels
+    uint16_t height;        // Height of each frame in pixels
+    uint16_t frames;        // Number of frames
+    uint16_t offsets[0];    // Start of each frame, in bytes from the end of this table
+};
+
+/**
+  * Class definition for a MicroBitImageAtlas.
+  *
+  * A MicroBitImageAtlas is a read-only set of equally sized images, compressed and
+  * kept in flash. Frames are decoded straight into an existing MicroBitImage, such as
+  * the display's back buffer, so no heap is needed to hold the atlas itself.
+  */
+class MicroBitImageAtlas
+{
+    const ImageAtlasData *atlas;    // Pointer to the atlas in flash
+
+    /**
+      * Get the start of the compressed stream for the given frame.
+      */
+    const uint8_t *getFrameData(int frame) const
+    {
+        return (const uint8_t *)&atlas->offsets[atlas->frames] + atlas->offsets[frame];
+    }
+
+    public:
+
+    /**
+      * Constructor.
+      * Create an atlas from a specially prepared constant array, with no copying.
+      *
+      * @param data The atlas: width, height and frame count as 16 bit values, a 16 bit offset for each
+      *             frame, then the compressed frames. The array has to be 2-byte aligned.
+      *
+      * @code
+      * // Two 5x5 frames: a filled square, then a hollow one.
+      * static const uint8_t squares[] __attribute__ ((aligned (4))) = {
+      *     5, 0, 5, 0, 2, 0,                       // width, height, frames
+      *     0, 0, 2, 0,                             // offsets
+      *     0x98, 255,                              // 25 x 255
+      *     0x84, 255, 0x80, 255, 0x82, 0, 0x81, 255, 0x82, 0, 0x81, 255, 0x82, 0, 0x85, 255 };
+      *
+      * MicroBitImageAtlas atlas(squares);
+      * @endcode
+      */
+    MicroBitImageAtlas(const uint8_t *data);
+
+    /**
+      * Gets the width of each frame.
+      *
+      * @return The width of each frame, in pixels.
+      */
+    int getWidth() const
+    {
+        return atlas->width;
+    }
+
+    /**
+      * Gets the height of each frame.
+      *
+      * @return The height of each frame, in pixels.
+      */
+    int getHeight() const
+    {
+        return atlas->height;
+    }
+
+    /**
+      * Gets the number of frames held in the atlas.
+      *
+      * @return The number of frames.
+      */
+    int getFrameCount() const
+    {
+        return atlas->frames;
+    }
+
+    /**
+      * Decodes a frame directly into the given image, at the given co-ordinates.
+      *
+      * Only the part of the frame that lands within the image is written, and nothing is
+      * allocated beyond the copy-on-write of the destination, should it be shared.
+      *
+      * @param image The MicroBitImage to write to.
+      *
+      * @param frame The index of the frame to decode.
+      *
+      * @param x The leftmost X co-ordinate in the image where the frame should be placed. Defaults to 0.
+      *
+      * @param y The uppermost Y co-ordinate in the image where the frame should be placed. Defaults to 0.
+      *
+      * @param alpha set to 1 if zero pixels in the frame should be treated as transparent. Set to 0 otherwise. Defaults to 0.
+      *
+      * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the frame does not exist.
+      *
+      * @code
+      * MicroBitImageAtlas atlas(squares);
+      * MicroBitImage& frame = uBit.display.getBackBuffer();
+      * atlas.paste(frame, 1);
+      * uBit.display.swap();
+      * @endcode
+      */
+    int paste(MicroBitImage &image, int frame, int16_t x = 0, int16_t y = 0, uint8_t alpha = 0) const;
+
+    /**
+      * Decodes a frame into a new MicroBitImage.
+      *
+      * @param frame The index of the frame to decode.
+      *
+      * @return A new MicroBitImage holding the frame, or the empty image if the frame does not exist.
+      */
+    MicroBitImage getFrame(int frame) const;
+};
+
+#endif
@@ -0,0 +1,399 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 British Broadcasting Corporation.
+This software is provided by Lancaster University by arrangement with the BBC.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef MICROBIT_MONO_IMAGE_H
+#define MICROBIT_MONO_IMAGE_H
+
+#include "mbed.h"
+#include "MicroBitConfig.h"
+#include "MicroBitImage.h"
+#include "RefCounted.h"
+
+struct MonoImageData : RefCounted
+{
+    uint16_t width;     // Width in pixels
+    uint16_t height;    // Height in pixels
+    uint32_t data[0];   // Packed bitmap, one bit per pixel. Each row starts on a word boundary, leftmost pixel in bit 0.
+};
+
+/**
+  * Class definition for a MicroBitMonoImage.
+  *
+  * A MicroBitMonoImage is a bitmap with one bit per pixel, for images that are simply on or off
+  * such as icons, sprites and rendered text. It uses an eighth of the memory of a MicroBitImage,
+  * and its operations work on 32 pixels at a time.
+  * n.b. This is a mutable, managed type.
+  */
+class MicroBitMonoImage
+{
+    MonoImageData *ptr;     // Pointer to payload data
+
+    /**
+      * Internal constructor which provides sanity checking and initialises class properties.
+      *
+      * @param x the width of the image
+      *
+      * @param y the height of the image
+      */
+    void init(const int16_t x, const int16_t y);
+
+    /**
+      * Internal constructor which defaults to the Empty Image instance variable
+      */
+    void init_empty();
+
+    /**
+      * Ensures this instance holds the only reference to its bitmap, copying it if it is
+      * shared with another MicroBitMonoImage or resides in flash.
+      */
+    void unshare();
+
+    public:
+    static MicroBitMonoImage EmptyImage;    // Shared representation of a null image.
+
+    /**
+      * Return the packed bitmap. Each row is getStride() words long.
+      *
+      * The bitmap may be shared with other MicroBitMonoImage instances, or reside in flash,
+      * so it should only be read. Use getMutableBitmap() to modify it.
+      */
+    const uint32_t *getBitmap() const
+    {
+        return ptr->data;
+    }
+
+    /**
+      * Return the packed bitmap, that can safely be modified. Each row is getStride() words long.
+      *
+      * As with MicroBitImage, if the bitmap is shared with another instance or resides in flash,
+      * this instance first takes a private copy of it.
+      */
+    uint32_t *getMutableBitmap()
+    {
+        unshare();
+        return ptr->data;
+    }
+
+    /**
+      * Constructor.
+      * Create an image from a specially prepared constant array, with no copying. Will call ptr->incr().
+      *
+      * @param ptr The literal - the first word should be 0xffff | width << 16, the second the height,
+      *            then each row of the bitmap, padded to a whole number of words with zeroes.
+      *            The literal has to be 4-byte aligned.
+      *
+      * @code
+      * static const uint32_t heart[] __attribute__ ((aligned (4))) = { 0x0005ffff, 5, 0x0a, 0x1f, 0x1f, 0x0e, 0x04 }; // a cute heart
+      * MicroBitMonoImage i((MonoImageData*)(void*)heart);
+      * @endcode
+      */
+    MicroBitMonoImage(MonoImageData *ptr);
+
+    /**
+      * Default Constructor.
+      * Creates a new reference to the empty MicroBitMonoImage bitmap
+      *
+      * @code
+      * MicroBitMonoImage i(); //an empty image instance
+      * @endcode
+      */
+    MicroBitMonoImage();
+
+    /**
+      * Copy Constructor.
+      * Add ourselves as a reference to an existing MicroBitMonoImage.
+      *
+      * @param image The MicroBitMonoImage to reference.
+      *
+      * @code
+      * MicroBitMonoImage i(5,5);
+      * MicroBitMonoImage i2(i); //points to i
+      * @endcode
+      */
+    MicroBitMonoImage(const MicroBitMonoImage &image);
+
+    /**
+      * Constructor.
+      * Create a blank bitmap representation of a given size.
+      *
+      * @param x the width of the image.
+      *
+      * @param y the height of the image.
+      *
+      * A copy of the image is made in RAM, as images are mutable.
+      */
+    MicroBitMonoImage(const int16_t x, const int16_t y);
+
+    /**
+      * Constructor.
+      * Create a packed copy of the given image. Any non zero pixel is set.
+      *
+      * @param image The MicroBitImage to convert.
+      *
+      * @code
+      * MicroBitImage i("0,255,0,255,0\n255,255,255,255,255\n255,255,255,255,255\n0,255,255,255,0\n0,0,255,0,0\n");
+      * MicroBitMonoImage heart(i);
+      * @endcode
+      */
+    explicit MicroBitMonoImage(MicroBitImage image);
+
+    /**
+      * Destructor.
+      *
+      * Removes buffer resources held by the instance.
+      */
+    ~MicroBitMonoImage();
+
+    /**
+      * Copy assign operation.
+      *
+      * Called when one MicroBitMonoImage is assigned the value of another using the '=' operator.
+      *
+      * Decrement our reference count and free up the buffer as necessary.
+      *
+      * Then, update our buffer to refer to that of the supplied MicroBitMonoImage,
+      * and increase its reference count.
+      *
+      * @param i The MicroBitMonoImage to reference.
+      */
+    MicroBitMonoImage& operator = (const MicroBitMonoImage& i);
+
+#if CONFIG_ENABLED(MICROBIT_MOVE_SEMANTICS)
+    /**
+      * Move constructor.
+      * Takes over the data of a MicroBitMonoImage that is about to be destroyed, without
+      * changing its reference count.
+      *
+      * @param i The MicroBitMonoImage to move from. It is left as the empty image.
+      */
+    MicroBitMonoImage(MicroBitMonoImage &&i);
+
+    /**
+      * Move assign operation.
+      * Releases our current data, and takes over that of a MicroBitMonoImage that is about to
+      * be destroyed, without changing its reference count.
+      *
+      * @param i The MicroBitMonoImage to move from. It is left as the empty image.
+      */
+    MicroBitMonoImage& operator = (MicroBitMonoImage &&i);
+#endif
+
+    /**
+      * Equality operation.
+      *
+      * Called when one MicroBitMonoImage is tested to be equal to another using the '==' operator.
+      *
+      * @param i The MicroBitMonoImage to test ourselves against.
+      *
+      * @return true if this MicroBitMonoImage is identical to the one supplied, false otherwise.
+      */
+    bool operator== (const MicroBitMonoImage& i);
+
+    /**
+      * Clears all pixels in this image.
+      */
+    void clear();
+
+    /**
+      * Sets or clears the pixel at the given co-ordinates.
+      *
+      * @param x The co-ordinate of the pixel to change.
+      *
+      * @param y The co-ordinate of the pixel to change.
+      *
+      * @param value Any non zero value sets the pixel, zero clears it.
+      *
+      * @return MICROBIT_OK, or MICROBIT_INVALID_PARAMETER.
+      *
+      * @note all coordinates originate from the top left of an image.
+      */
+    int setPixelValue(int16_t x , int16_t y, uint8_t value);
+
+    /**
+      * Retrieves the value of a given pixel.
+      *
+      * @param x The x co-ordinate of the pixel to read. Must be within the dimensions of the image.
+      *
+      * @param y The y co-ordinate of the pixel to read. Must be within the dimensions of the image.
+      *
+      * @return 255 if the pixel is set, 0 if it is clear, or MICROBIT_INVALID_PARAMETER.
+      */
+    int getPixelValue(int16_t x , int16_t y);
+
+    /**
+      * Pastes a given bitmap at the given co-ordinates.
+      *
+      * Any pixels in the relevant area of this image are replaced.
+      *
+      * @param image The MicroBitMonoImage to paste.
+      *
+      * @param x The leftmost X co-ordinate in this image where the given image should be pasted. Defaults to 0.
+      *
+      * @param y The uppermost Y co-ordinate in this image where the given image should be pasted. Defaults to 0.
+      *
+      * @param alpha set to 1 if clear pixels in given image should be treated as transparent. Set to 0 otherwise.  Defaults to 0.
+      *
+      * @return The number of pixels written.
+      *
+      * @code
+      * MicroBitMonoImage sprite(5,5);
+      * MicroBitMonoImage screen(5,5);
+      * screen.paste(sprite, 1, 0, 1);
+      * @endcode
+      */
+    int paste(const MicroBitMonoImage &image, int16_t x = 0, int16_t y = 0, uint8_t alpha = 0);
+
+    /**
+      * Prints a character to the image at the given location
+      *
+      * @param c The character to display.
+      *
+      * @param x The x co-ordinate of on the image to place the top left of the character. Defaults to 0.
+      *
+      * @param y The y co-ordinate of on the image to place the top left of the character. Defaults to 0.
+      *
+      * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER.
+      *
+      * @code
+      * MicroBitMonoImage i(5,5);
+      * i.print('a');
+      * @endcode
+      */
+    int print(char c, int16_t x = 0, int16_t y = 0);
+
+    /**
+      * Shifts the pixels in this Image a given number of pixels to the left.
+      *
+      * @param n The number of pixels to shift.
+      *
+      * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER.
+      */
+    int shiftLeft(int16_t n);
+
+    /**
+      * Shifts the pixels in this Image a given number of pixels to the right.
+      *
+      * @param n The number of pixels to shift.
+      *
+      * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER.
+      */
+    int shiftRight(int16_t n);
+
+    /**
+      * Shifts the pixels in this Image a given number of pixels to upward.
+      *
+      * @param n The number of pixels to shift.
+      *
+      * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER.
+      */
+    int shiftUp(int16_t n);
+
+    /**
+      * Shifts the pixels in this Image a given number of pixels to downward.
+      *
+      * @param n The number of pixels to shift.
+      *
+      * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER.
+      */
+    int shiftDown(int16_t n);
+
+    /**
+      * Gets the width of this image.
+      *
+      * @return The width of this image.
+      */
+    int getWidth() const
+    {
+        return ptr->width;
+    }
+
+    /**
+      * Gets the height of this image.
+      *
+      * @return The height of this image.
+      */
+    int getHeight() const
+    {
+        return ptr->height;
+    }
+
+    /**
+      * Gets the number of 32 bit words used to store each row of the bitmap.
+      *
+      * @return The stride of the bitmap, in words.
+      */
+    int getStride() const
+    {
+        return (ptr->width + 31) >> 5;
+    }
+
+    /**
+      * Gets number of bytes in the bitmap.
+      *
+      * @return The size of the bitmap.
+      */
+    int getSize() const
+    {
+        return getStride() * ptr->height * 4;
+    }
+
+    /**
+      * Crops the image to the given dimensions.
+      *
+      * @param startx the location to start the crop in the x-axis
+      *
+      * @param starty the location to start the crop in the y-axis
+      *
+      * @param cropWidth the width of the desired cropped region
+      *
+      * @param cropHeight the height of the desired cropped region
+      *
+      * @return a new MicroBitMonoImage holding the part of the requested region that lies within this image.
+      */
+    MicroBitMonoImage crop(int startx, int starty, int cropWidth, int cropHeight);
+
+    /**
+      * Check if image is read-only (i.e., residing in flash).
+      */
+    bool isReadOnly();
+
+    /**
+      * Create a copy of the image bitmap. Used particularly, when isReadOnly() is true.
+      *
+      * @return an instance of MicroBitMonoImage which can be modified independently of the current instance
+      */
+    MicroBitMonoImage clone();
+
+    /**
+      * Converts this image into a MicroBitImage, with one byte per pixel.
+      *
+      * @param value The brightness to give set pixels. Defaults to 255.
+      *
+      * @return a new MicroBitImage of the same size.
+      */
+    MicroBitImage toImage(uint8_t value = 255);
+};
+
+#endif
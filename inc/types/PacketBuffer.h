@@ -46,6 +46,11 @@ struct PacketData : RefCounted
 class PacketBuffer
 {
     PacketData      *ptr;     // Pointer to payload data
+    uint8_t         offset;   // The first byte of the payload this instance refers to
+    uint8_t         len;      // The number of bytes of the payload this instance refers to
+
+    // StringView holds a reference to our PacketData, to keep the bytes it refers to alive.
+    friend class StringView;
 
     public:
 
@@ -149,6 +154,26 @@ class PacketBuffer
       */
     PacketBuffer& operator = (const PacketBuffer& p);
 
+#if CONFIG_ENABLED(MICROBIT_MOVE_SEMANTICS)
+    /**
+      * Move constructor.
+      * Takes over the data of a PacketBuffer that is about to be destroyed, without
+      * changing its reference count.
+      *
+      * @param p The PacketBuffer to move from. It is left as an empty buffer.
+      */
+    PacketBuffer(PacketBuffer &&p);
+
+    /**
+      * Move assign operation.
+      * Exchanges our data with that of a PacketBuffer that is about to be destroyed,
+      * without changing either reference count.
+      *
+      * @param p The PacketBuffer to move from. It is left holding our previous data, which it releases when destroyed.
+      */
+    PacketBuffer& operator = (PacketBuffer &&p);
+#endif
+
     /**
       * Array access operation (read).
       *
@@ -264,6 +289,25 @@ class PacketBuffer
       */
     void setRSSI(uint8_t rssi);
 
+    /**
+      * Creates a PacketBuffer that refers to part of this one, without copying.
+      *
+      * The slice shares the data of this buffer, so changes made through either are seen by both.
+      * The range is clipped to the end of this buffer.
+      *
+      * @param offset The index of the first byte of the slice.
+      *
+      * @param length The number of bytes in the slice. Defaults to the rest of the buffer.
+      *
+      * @return A PacketBuffer referring to the requested bytes, or an empty buffer if offset is out of range.
+      *
+      * @code
+      * PacketBuffer p = uBit.radio.datagram.recv();
+      * PacketBuffer body = p.slice(2);         // Everything after a two byte header.
+      * @endcode
+      */
+    PacketBuffer slice(int offset, int length = 255);
+
     static PacketBuffer EmptyPacket;
 };
 
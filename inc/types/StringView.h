@@ -0,0 +1,293 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 British Broadcasting Corporation.
+This software is provided by Lancaster University by arrangement with the BBC.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef STRING_VIEW_H
+#define STRING_VIEW_H
+
+#include "MicroBitConfig.h"
+#include "ManagedString.h"
+
+/**
+  * Class definition for a StringView.
+  *
+  * A StringView refers to a run of characters held elsewhere, without copying them.
+  * Views taken of a ManagedString or PacketBuffer hold a reference to its data, so remain valid
+  * for as long as the view exists. Views of a plain character buffer do not, and must not outlive it.
+  *
+  * Taking substrings, tokenizing and comparing views never allocates memory.
+  *
+  * n.b. The characters of a StringView are not NULL terminated.
+  *
+  * @code
+  * char line[32];
+  * int n = uBit.serial.readUntil((uint8_t *)line, sizeof(line), "\n");
+  *
+  * StringView command(line, n);
+  * StringView word;
+  *
+  * while (command.nextToken(word, ' '))
+  *     if (word == "led")
+  *         ...
+  * @endcode
+  */
+class StringView
+{
+    RefCounted *anchor;     // The ManagedString or PacketBuffer data this view refers to, or NULL for a plain buffer.
+    const char *data;       // The first character of the view.
+    uint16_t len;           // The number of characters in the view.
+    bool packetAnchor;      // true if the anchor is the data of a PacketBuffer, rather than a ManagedString.
+
+    /**
+      * Internal constructor, referring to part of the given view's characters.
+      */
+    StringView(const StringView &view, int16_t start, int16_t length);
+
+    public:
+
+    /**
+      * Constructor.
+      * Creates an empty view.
+      */
+    StringView();
+
+    /**
+      * Constructor.
+      * Creates a view of a character buffer. The buffer is not copied, and must remain valid
+      * for as long as the view is used.
+      *
+      * @param str The characters to view.
+      *
+      * @param length The number of characters to view.
+      */
+    StringView(const char *str, int16_t length);
+
+    /**
+      * Constructor.
+      * Creates a view of a NULL terminated string. The string is not copied, and must remain
+      * valid for as long as the view is used.
+      *
+      * @param str The characters to view.
+      */
+    StringView(const char *str);
+
+    /**
+      * Constructor.
+      * Creates a view of the whole of a ManagedString. The characters are not copied.
+      *
+      * @param s The ManagedString to view.
+      */
+    StringView(const ManagedString &s);
+
+    /**
+      * Constructor.
+      * Creates a view of part of a ManagedString. The characters are not copied.
+      * The range is clipped to the end of the string.
+      *
+      * @param s The ManagedString to view.
+      *
+      * @param start The index of the first character to view.
+      *
+      * @param length The number of characters to view.
+      *
+      * @code
+      * ManagedString s("abcd");
+      * StringView v(s, 1, 2); // "bc"
+      * @endcode
+      */
+    StringView(const ManagedString &s, int16_t start, int16_t length);
+
+    /**
+      * Constructor.
+      * Creates a view of the bytes of a PacketBuffer, such as a received radio datagram,
+      * as characters. The bytes are not copied, so later changes to the buffer are seen by the view.
+      *
+      * @param buffer The PacketBuffer to view.
+      *
+      * @code
+      * StringView command(uBit.radio.datagram.recv());
+      * @endcode
+      */
+    StringView(PacketBuffer buffer);
+
+    /**
+      * Copy constructor.
+      * Refers to the same characters as the given view.
+      *
+      * @param view The StringView to copy.
+      */
+    StringView(const StringView &view);
+
+    /**
+      * Destructor.
+      *
+      * Releases our reference to the underlying ManagedString data, if any.
+      */
+    ~StringView();
+
+    /**
+      * Copy assign operation.
+      *
+      * @param view The StringView to refer to.
+      */
+    StringView& operator = (const StringView &view);
+
+#if CONFIG_ENABLED(MICROBIT_MOVE_SEMANTICS)
+    /**
+      * Move constructor.
+      * Takes over the data of a StringView that is about to be destroyed, without
+      * changing its reference count.
+      *
+      * @param view The StringView to move from. It is left as an empty view.
+      */
+    StringView(StringView &&view);
+
+    /**
+      * Move assign operation.
+      * Releases our current data, and takes over that of a StringView that is about to
+      * be destroyed, without changing its reference count.
+      *
+      * @param view The StringView to move from. It is left as an empty view.
+      */
+    StringView& operator = (StringView &&view);
+#endif
+
+    /**
+      * Equality operation.
+      *
+      * @param view The characters to compare against.
+      *
+      * @return true if both views hold the same characters, false otherwise.
+      */
+    bool operator== (const StringView &view) const;
+
+    /**
+      * Inequality operation.
+      *
+      * @param view The characters to compare against.
+      *
+      * @return true if the views hold different characters, false otherwise.
+      */
+    bool operator!= (const StringView &view) const
+    {
+        return !(*this == view);
+    }
+
+    /**
+      * Gets the number of characters in the view.
+      *
+      * @return The length of the view.
+      */
+    int16_t length() const
+    {
+        return len;
+    }
+
+    /**
+      * Gets the characters of the view. n.b. These are not NULL terminated.
+      *
+      * @return A pointer to the first character of the view.
+      */
+    const char *getBytes() const
+    {
+        return data;
+    }
+
+    /**
+      * Gets the character at the given index.
+      *
+      * @param index The position of the character to return.
+      *
+      * @return the character at the given index, or 0 if the index is out of range.
+      */
+    char charAt(int16_t index) const
+    {
+        return (index >= 0 && index < len) ? data[index] : 0;
+    }
+
+    /**
+      * Creates a view of part of this view, without copying.
+      *
+      * @param start The index of the first character.
+      *
+      * @param length The number of characters, clipped to the end of this view.
+      *
+      * @return A StringView of the requested characters, or an empty view if start is out of range.
+      */
+    StringView substring(int16_t start, int16_t length) const;
+
+    /**
+      * Finds the first occurrence of a character.
+      *
+      * @param c The character to look for.
+      *
+      * @param start The index to start looking from. Defaults to 0.
+      *
+      * @return The index of the character, or -1 if it does not occur.
+      */
+    int16_t indexOf(char c, int16_t start = 0) const;
+
+    /**
+      * Determines if this view begins with the given characters.
+      *
+      * @param prefix The characters to look for.
+      *
+      * @return true if the view starts with prefix, false otherwise.
+      */
+    bool startsWith(const StringView &prefix) const;
+
+    /**
+      * Removes the next token from the front of this view.
+      *
+      * Runs of the delimiter are skipped, so empty tokens are never returned.
+      *
+      * @param token Set to a view of the next token.
+      *
+      * @param delimiter The character that separates tokens.
+      *
+      * @return true if a token was found, false if none remain.
+      */
+    bool nextToken(StringView &token, char delimiter);
+
+    /**
+      * Parses the view as a decimal integer, with an optional leading sign.
+      *
+      * @param value Set to the parsed integer.
+      *
+      * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the view is not a decimal integer
+      *         or is out of the range of an int.
+      */
+    int toInt(int &value) const;
+
+    /**
+      * Creates a ManagedString holding the characters of this view.
+      *
+      * No copy is made if the view covers the whole of a ManagedString.
+      *
+      * @return A ManagedString holding the same characters.
+      */
+    ManagedString toManagedString() const;
+};
+
+#endif
@@ -50,7 +50,7 @@ void on_confirmation(uint16_t handle)
     if(handle == rxCharacteristic->getValueAttribute().getHandle())
     {
         txBufferTail = txBufferHead;
-        MicroBitEvent(MICROBIT_ID_NOTIFY, MICROBIT_UART_S_EVT_TX_EMPTY);
+        MicroBitEvent(MICROBIT_ID_NOTIFY, MICROBIT_UART_S_EVT_TX_EMPTY, CREATE_AND_FIRE_NO_TIMESTAMP);
     }
 }
 
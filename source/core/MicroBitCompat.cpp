@@ -60,42 +60,99 @@ int string_reverse(char *s)
     return MICROBIT_OK;
 }
 
+/**
+  * Divides by ten using only shifts, adds and a single multiply.
+  * The Cortex-M0 has no hardware divider, so this is many times faster than the '/' operator.
+  *
+  * @param n The number to divide.
+  *
+  * @return n / 10, rounded down.
+  */
+static inline uint32_t udiv10(uint32_t n)
+{
+    // Approximate n * 0.8 by a series of shifts, then scale down to n / 10.
+    uint32_t q = (n >> 1) + (n >> 2);
+    q += q >> 4;
+    q += q >> 8;
+    q += q >> 16;
+    q >>= 3;
+
+    // The approximation may be one too small, which the remainder reveals.
+    return q + ((n - q * 10) > 9);
+}
+
 /**
   * Converts a given integer into a string representation.
   *
   * @param n The number to convert.
   *
   * @param s A pointer to the buffer where the resulting string will be stored.
+  *          This needs room for at least 12 characters.
   *
   * @return MICROBIT_OK, or MICROBIT_INVALID_PARAMETER.
   */
 int itoa(int n, char *s)
 {
-    int i = 0;
-    int positive = (n >= 0);
+    return fixed_itoa(n, 0, s) < 0 ? MICROBIT_INVALID_PARAMETER : MICROBIT_OK;
+}
+
+/**
+  * Converts a fixed point decimal number into a string representation, such as a
+  * temperature held in tenths of a degree. No division or heap allocation is used.
+  *
+  * @param value The number to convert, scaled up by 10 to the power of places.
+  *
+  * @param places The number of digits after the decimal point, from 0 to 9.
+  *
+  * @param s A pointer to the buffer where the resulting string will be stored.
+  *          This needs room for at least 13 characters.
+  *
+  * @return The number of characters written, excluding the terminator, or MICROBIT_INVALID_PARAMETER.
+  *
+  * @code
+  * char s[13];
+  * fixed_itoa(-1234, 2, s); // "-12.34"
+  * fixed_itoa(5, 3, s);     // "0.005"
+  * @endcode
+  */
+int fixed_itoa(int value, int places, char *s)
+{
+    char digits[12];
+    char *p = digits + sizeof(digits);
+    int count = 0;
+    int len = 0;
 
-    if (s == NULL)
+    if (s == NULL || places < 0 || places > 9)
         return MICROBIT_INVALID_PARAMETER;
 
-    // Record the sign of the number,
-    // Ensure our working value is positive.
-    if (positive)
-        n = -n;
+    // Work on the magnitude as unsigned, so that INT_MIN is handled too.
+    uint32_t n = value < 0 ? -(uint32_t)value : (uint32_t)value;
 
-    // Calculate each character, starting with the LSB.
+    // Generate digits from the least significant end, until we have every
+    // fractional digit and at least one integer digit.
     do {
-         s[i++] = abs(n % 10) + '0';
-    } while (abs(n /= 10) > 0);
+        uint32_t q = udiv10(n);
 
-    // Add a negative sign as needed
-    if (!positive)
-        s[i++] = '-';
+        *--p = '0' + (n - q * 10);
+        n = q;
+        count++;
+    } while (n > 0 || count <= places);
 
-    // Terminate the string.
-    s[i] = '\0';
+    if (value < 0)
+        s[len++] = '-';
 
-    // Flip the order.
-    string_reverse(s);
+    for (int i = 0; i < count - places; i++)
+        s[len++] = *p++;
 
-    return MICROBIT_OK;
+    if (places > 0)
+    {
+        s[len++] = '.';
+
+        for (int i = 0; i < places; i++)
+            s[len++] = *p++;
+    }
+
+    s[len] = '\0';
+
+    return len;
 }
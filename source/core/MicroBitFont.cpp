@@ -46,6 +46,17 @@ DEALINGS IN THE SOFTWARE.
 
 #include "MicroBitConfig.h"
 #include "MicroBitFont.h"
+#include "ErrorNo.h"
+
+#if MICROBIT_FONT_GLYPH_CACHE_SIZE < 1 || (MICROBIT_FONT_GLYPH_CACHE_SIZE & (MICROBIT_FONT_GLYPH_CACHE_SIZE - 1))
+#error "MICROBIT_FONT_GLYPH_CACHE_SIZE must be a power of two"
+#endif
+
+// A direct mapped cache of rasterized glyphs, indexed by the low bits of the character.
+// Entries are tagged with their character, where zero (never a printable character) marks an empty entry.
+static MicroBitGlyph glyphCache[MICROBIT_FONT_GLYPH_CACHE_SIZE];
+static char glyphCacheTag[MICROBIT_FONT_GLYPH_CACHE_SIZE];
+static const unsigned char *glyphCacheFont = NULL;
 
 const unsigned char pendolino3[475] = {
 0x0, 0x0, 0x0, 0x0, 0x0, 0x8, 0x8, 0x8, 0x0, 0x8, 0xa, 0x4a, 0x40, 0x0, 0x0, 0xa, 0x5f, 0xea, 0x5f, 0xea, 0xe, 0xd9, 0x2e, 0xd3, 0x6e, 0x19, 0x32, 0x44, 0x89, 0x33, 0xc, 0x92, 0x4c, 0x92, 0x4d, 0x8, 0x8, 0x0, 0x0, 0x0, 0x4, 0x88, 0x8, 0x8, 0x4, 0x8, 0x4, 0x84, 0x84, 0x88, 0x0, 0xa, 0x44, 0x8a, 0x40, 0x0, 0x4, 0x8e, 0xc4, 0x80, 0x0, 0x0, 0x0, 0x4, 0x88, 0x0, 0x0, 0xe, 0xc0, 0x0, 0x0, 0x0, 0x0, 0x8, 0x0, 0x1, 0x22, 0x44, 0x88, 0x10, 0xc, 0x92, 0x52, 0x52, 0x4c, 0x4, 0x8c, 0x84, 0x84, 0x8e, 0x1c, 0x82, 0x4c, 0x90, 0x1e, 0x1e, 0xc2, 0x44, 0x92, 0x4c, 0x6, 0xca, 0x52, 0x5f, 0xe2, 0x1f, 0xf0, 0x1e, 0xc1, 0x3e, 0x2, 0x44, 0x8e, 0xd1, 0x2e, 0x1f, 0xe2, 0x44, 0x88, 0x10, 0xe, 0xd1, 0x2e, 0xd1, 0x2e, 0xe, 0xd1, 0x2e, 0xc4, 0x88, 0x0, 0x8, 0x0, 0x8, 0x0, 0x0, 0x4, 0x80, 0x4, 0x88, 0x2, 0x44, 0x88, 0x4, 0x82, 0x0, 0xe, 0xc0, 0xe, 0xc0, 0x8, 0x4, 0x82, 0x44, 0x88, 0xe, 0xd1, 0x26, 0xc0, 0x4, 0xe, 0xd1, 0x35, 0xb3, 0x6c, 0xc, 0x92, 0x5e, 0xd2, 0x52, 0x1c, 0x92, 0x5c, 0x92, 0x5c, 0xe, 0xd0, 0x10, 0x10, 0xe, 0x1c, 0x92, 0x52, 0x52, 0x5c, 0x1e, 0xd0, 0x1c, 0x90, 0x1e, 0x1e, 0xd0, 0x1c, 0x90, 0x10, 0xe, 0xd0, 0x13, 0x71, 0x2e, 0x12, 0x52, 0x5e, 0xd2, 0x52, 0x1c, 0x88, 0x8, 0x8, 0x1c, 0x1f, 0xe2, 0x42, 0x52, 0x4c, 0x12, 0x54, 0x98, 0x14, 0x92, 0x10, 0x10, 0x10, 0x10, 0x1e, 0x11, 0x3b, 0x75, 0xb1, 0x31, 0x11, 0x39, 0x35, 0xb3, 0x71, 0xc, 0x92, 0x52, 0x52, 0x4c, 0x1c, 0x92, 0x5c, 0x90, 0x10, 0xc, 0x92, 0x52, 0x4c, 0x86, 0x1c, 0x92, 0x5c, 0x92, 0x51, 0xe, 0xd0, 0xc, 0x82, 0x5c, 0x1f, 0xe4, 0x84, 0x84, 0x84, 0x12, 0x52, 0x52, 0x52, 0x4c, 0x11, 0x31, 0x31, 0x2a, 0x44, 0x11, 0x31, 0x35, 0xbb, 0x71, 0x12, 0x52, 0x4c, 0x92, 0x52, 0x11, 0x2a, 0x44, 0x84, 0x84, 0x1e, 0xc4, 0x88, 0x10, 0x1e, 0xe, 0xc8, 0x8, 0x8, 0xe, 0x10, 0x8, 0x4, 0x82, 0x41, 0xe, 0xc2, 0x42, 0x42, 0x4e, 0x4, 0x8a, 0x40, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x1f, 0x8, 0x4, 0x80, 0x0, 0x0, 0x0, 0xe, 0xd2, 0x52, 0x4f, 0x10, 0x10, 0x1c, 0x92, 0x5c, 0x0, 0xe, 0xd0, 0x10, 0xe, 0x2, 0x42, 0x4e, 0xd2, 0x4e, 0xc, 0x92, 0x5c, 0x90, 0xe, 0x6, 0xc8, 0x1c, 0x88, 0x8, 0xe, 0xd2, 0x4e, 0xc2, 0x4c, 0x10, 0x10, 0x1c, 0x92, 0x52, 0x8, 0x0, 0x8, 0x8, 0x8, 0x2, 0x40, 0x2, 0x42, 0x4c, 0x10, 0x14, 0x98, 0x14, 0x92, 0x8, 0x8, 0x8, 0x8, 0x6, 0x0, 0x1b, 0x75, 0xb1, 0x31, 0x0, 0x1c, 0x92, 0x52, 0x52, 0x0, 0xc, 0x92, 0x52, 0x4c, 0x0, 0x1c, 0x92, 0x5c, 0x90, 0x0, 0xe, 0xd2, 0x4e, 0xc2, 0x0, 0xe, 0xd0, 0x10, 0x10, 0x0, 0x6, 0xc8, 0x4, 0x98, 0x8, 0x8, 0xe, 0xc8, 0x7, 0x0, 0x12, 0x52, 0x52, 0x4f, 0x0, 0x11, 0x31, 0x2a, 0x44, 0x0, 0x11, 0x31, 0x35, 0xbb, 0x0, 0x12, 0x4c, 0x8c, 0x92, 0x0, 0x11, 0x2a, 0x44, 0x98, 0x0, 0x1e, 0xc4, 0x88, 0x1e, 0x6, 0xc4, 0x8c, 0x84, 0x86, 0x8, 0x8, 0x8, 0x8, 0x8, 0x18, 0x8, 0xc, 0x88, 0x18, 0x0, 0x0, 0xc, 0x83, 0x60};
@@ -97,3 +108,94 @@ MicroBitFont MicroBitFont::getSystemFont()
 {
     return MicroBitFont::systemFont;
 }
+
+/**
+  * Decodes a character of a font into a MicroBitGlyph.
+  *
+  * @param data The five row bytes of the character, each with its leftmost pixel in bit 4.
+  *
+  * @param glyph The MicroBitGlyph to fill in.
+  */
+static void rasterizeGlyph(const unsigned char *data, MicroBitGlyph *glyph)
+{
+    uint8_t lit = 0;
+
+    memset(glyph->columns, 0, MICROBIT_FONT_WIDTH);
+
+    for (int row = 0; row < MICROBIT_FONT_HEIGHT; row++)
+    {
+        // Reverse the row into our bit order. The upper bits of each byte are not part of the glyph.
+        uint8_t v = data[row];
+        uint8_t bits = ((v >> 4) & 0x01) | ((v >> 2) & 0x02) | (v & 0x04) | ((v << 2) & 0x08) | ((v << 4) & 0x10);
+
+        glyph->rows[row] = bits;
+        lit |= bits;
+
+        for (int col = 0; col < MICROBIT_FONT_WIDTH; col++)
+            if (bits & (1 << col))
+                glyph->columns[col] |= 1 << row;
+    }
+
+    if (lit == 0)
+    {
+        glyph->offset = 0;
+        glyph->width = MICROBIT_FONT_SPACE_WIDTH;
+        return;
+    }
+
+    int first = 0;
+    int last = MICROBIT_FONT_WIDTH - 1;
+
+    while (!(lit & (1 << first)))
+        first++;
+
+    while (!(lit & (1 << last)))
+        last--;
+
+    glyph->offset = first;
+    glyph->width = last - first + 1;
+}
+
+/**
+  * Provides a character of this font, pre-rasterized into row and column masks.
+  *
+  * Recently used glyphs are kept in a small cache, shared by all fonts, so drawing
+  * the same characters repeatedly does not decode them each time.
+  *
+  * @param c The character to fetch.
+  *
+  * @param glyph The MicroBitGlyph to fill in.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the font has no such character.
+  */
+int MicroBitFont::getGlyph(char c, MicroBitGlyph *glyph) const
+{
+    if (c < MICROBIT_FONT_ASCII_START || c > asciiEnd || glyph == NULL)
+        return MICROBIT_INVALID_PARAMETER;
+
+    int i = c & (MICROBIT_FONT_GLYPH_CACHE_SIZE - 1);
+
+    // Glyphs are drawn from both fibers and the display's interrupt handler, so keep the cache consistent.
+    // We may be called from within another critical section, so restore the interrupt state we found.
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    // The cache only holds the glyphs of one font at a time.
+    if (characters != glyphCacheFont)
+    {
+        memset(glyphCacheTag, 0, sizeof(glyphCacheTag));
+        glyphCacheFont = characters;
+    }
+
+    if (glyphCacheTag[i] != c)
+    {
+        rasterizeGlyph(characters + (c - MICROBIT_FONT_ASCII_START) * MICROBIT_FONT_HEIGHT, &glyphCache[i]);
+        glyphCacheTag[i] = c;
+    }
+
+    *glyph = glyphCache[i];
+
+    __set_PRIMASK(primask);
+
+    return MICROBIT_OK;
+}
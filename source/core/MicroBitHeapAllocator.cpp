@@ -52,6 +52,7 @@ DEALINGS IN THE SOFTWARE.
 #include "MicroBitHeapAllocator.h"
 #include "MicroBitDevice.h"
 #include "MicroBitCompat.h"
+#include "MicroBitFiber.h"
 #include "ErrorNo.h"
 
 #if CONFIG_ENABLED(MICROBIT_HEAP_ENABLED)
@@ -59,6 +60,9 @@ DEALINGS IN THE SOFTWARE.
 // A list of all active heap regions, and their dimensions in memory.
 HeapDefinition heap[MICROBIT_MAXIMUM_HEAPS] = { };
 uint8_t heap_count = 0;
+
+// An optional heap region reserved for allocations made from interrupt context.
+HeapDefinition irq_heap = { };
 extern "C" int __end__;
 
 #if CONFIG_ENABLED(MICROBIT_DBG) && CONFIG_ENABLED(MICROBIT_HEAP_DBG)
@@ -121,6 +125,12 @@ void microbit_heap_print()
         if(SERIAL_DEBUG) SERIAL_DEBUG->printf("\nHEAP %d: \n", i);
         microbit_heap_print(heap[i]);
     }
+
+    if (irq_heap.heap_start != NULL)
+    {
+        if(SERIAL_DEBUG) SERIAL_DEBUG->printf("\nIRQ HEAP: \n");
+        microbit_heap_print(irq_heap);
+    }
 }
 #endif
 
@@ -173,20 +183,63 @@ int microbit_create_heap(uint32_t start, uint32_t end)
     return MICROBIT_OK;
 }
 
+/**
+  * Create and initialise a given memory region as a heap dedicated to interrupt context allocations.
+  * Once created, any call to malloc or new made from an interrupt service routine is satisfied
+  * from this region only, and never from the main heaps. As interrupt handlers can then never
+  * modify the main heaps, allocations made from thread context run with interrupts enabled.
+  *
+  * @param start The start address of memory to use as the interrupt heap region.
+  *
+  * @param end The end address of memory to use as the interrupt heap region.
+  *
+  * @return MICROBIT_OK on success, MICROBIT_NOT_SUPPORTED if an interrupt heap already exists,
+  *         or MICROBIT_INVALID_PARAMETER if the region is not valid.
+  *
+  * @note Memory from this heap may be released from any context.
+  */
+int microbit_create_irq_heap(uint32_t start, uint32_t end)
+{
+    if (irq_heap.heap_start != NULL)
+        return MICROBIT_NOT_SUPPORTED;
+
+    // Sanity check. Ensure range is valid, large enough and word aligned.
+    if (end <= start || end - start < MICROBIT_HEAP_BLOCK_SIZE*2 || end % MICROBIT_HEAP_BLOCK_SIZE != 0 || start % MICROBIT_HEAP_BLOCK_SIZE != 0)
+        return MICROBIT_INVALID_PARAMETER;
+
+	// Disable IRQ temporarily to ensure no race conditions!
+    __disable_irq();
+
+    // Initialise the heap as being completely empty and available for use.
+    *((uint32_t *)start) = MICROBIT_HEAP_BLOCK_FREE | ((end - start) / MICROBIT_HEAP_BLOCK_SIZE);
+
+    // Record the dimensions of this new heap. Once heap_start is set, the heap is live.
+    irq_heap.heap_end = (uint32_t *)end;
+    irq_heap.heap_start = (uint32_t *)start;
+
+	// Enable Interrupts
+    __enable_irq();
+
+    return MICROBIT_OK;
+}
+
 /**
   * Attempt to allocate a given amount of memory from a given heap area.
   *
   * @param size The amount of memory, in bytes, to allocate.
   * @param heap The heap to allocate memory from.
+  * @param atomic If true, interrupts are disabled for the duration of the search. This may only be
+  *               false if the heap is never allocated from in interrupt context.
   *
   * @return A pointer to the allocated memory, or NULL if insufficient memory is available.
   */
-void *microbit_malloc(size_t size, HeapDefinition &heap)
+void *microbit_malloc(size_t size, HeapDefinition &heap, bool atomic = true)
 {
 	uint32_t	blockSize = 0;
 	uint32_t	blocksNeeded = size % MICROBIT_HEAP_BLOCK_SIZE == 0 ? size / MICROBIT_HEAP_BLOCK_SIZE : size / MICROBIT_HEAP_BLOCK_SIZE + 1;
 	uint32_t	*block;
 	uint32_t	*next;
+	uint32_t	header;
 
 	if (size <= 0)
 		return NULL;
@@ -195,17 +248,21 @@ void *microbit_malloc(size_t size, HeapDefinition &heap)
 	blocksNeeded++;
 
 	// Disable IRQ temporarily to ensure no race conditions!
-    __disable_irq();
+    if (atomic)
+        __disable_irq();
 
 	// We implement a first fit algorithm with cache to handle rapid churn...
     // We also defragment free blocks as we search, to optimise this and future searches.
 	block = heap.heap_start;
 	while (block < heap.heap_end)
 	{
+        // Sample the header only once, as an interrupt may release this block while we're looking at it.
+        header = *block;
+
 		// If the block is used, then keep looking.
-		if(!(*block & MICROBIT_HEAP_BLOCK_FREE))
+		if(!(header & MICROBIT_HEAP_BLOCK_FREE))
 		{
-			block += *block;
+			block += header;
 			continue;
 		}
 
@@ -238,7 +295,9 @@ void *microbit_malloc(size_t size, HeapDefinition &heap)
 	// We're full!
 	if (block >= heap.heap_end)
     {
-        __enable_irq();
+        if (atomic)
+            __enable_irq();
+
         return NULL;
     }
 
@@ -259,7 +318,8 @@ void *microbit_malloc(size_t size, HeapDefinition &heap)
 	}
 
 	// Enable Interrupts
-    __enable_irq();
+    if (atomic)
+        __enable_irq();
 
 	return block+1;
 }
@@ -280,18 +340,43 @@ void *malloc(size_t size)
     {
         heap_count = 0;
 
-        if(microbit_create_heap((uint32_t)(&__end__), (uint32_t)(MICROBIT_HEAP_END)) == MICROBIT_INVALID_PARAMETER)
+        if(microbit_create_heap((uint32_t)(&__end__), (uint32_t)(MICROBIT_HEAP_END - MICROBIT_HEAP_IRQ_SIZE)) == MICROBIT_INVALID_PARAMETER)
             microbit_panic(MICROBIT_HEAP_ERROR);
 
+#if MICROBIT_HEAP_IRQ_SIZE > 0
+        if(microbit_create_irq_heap((uint32_t)(MICROBIT_HEAP_END - MICROBIT_HEAP_IRQ_SIZE), (uint32_t)(MICROBIT_HEAP_END)) == MICROBIT_INVALID_PARAMETER)
+            microbit_panic(MICROBIT_HEAP_ERROR);
+#endif
+
         initialised = 1;
     }
 
-    // Assign the memory from the first heap created that has space.
-    for (int i=0; i < heap_count; i++)
+    p = NULL;
+
+    if (irq_heap.heap_start == NULL)
     {
-        p = microbit_malloc(size, heap[i]);
-        if (p != NULL)
-            break;
+        // Assign the memory from the first heap created that has space.
+        for (int i=0; i < heap_count; i++)
+        {
+            p = microbit_malloc(size, heap[i]);
+            if (p != NULL)
+                break;
+        }
+    }
+    else if (inInterruptContext())
+    {
+        // Interrupt handlers are confined to their own heap, so they never race with a search of the main heaps.
+        p = microbit_malloc(size, irq_heap);
+    }
+    else
+    {
+        // Only thread context code allocates from the main heaps, so we can leave interrupts enabled while we search.
+        for (int i=0; i < heap_count; i++)
+        {
+            p = microbit_malloc(size, heap[i], false);
+            if (p != NULL)
+                break;
+        }
     }
 
     if (p != NULL)
@@ -347,6 +432,16 @@ void free(void *mem)
         }
     }
 
+    // The interrupt heap uses the same block format, so memory is released in the same way.
+    if(memory > irq_heap.heap_start && memory < irq_heap.heap_end)
+    {
+        if (*cb == 0 || *cb & MICROBIT_HEAP_BLOCK_FREE)
+            microbit_panic(MICROBIT_HEAP_ERROR);
+
+        *cb |= MICROBIT_HEAP_BLOCK_FREE;
+        return;
+    }
+
     // If we reach here, then the memory is not part of any registered heap.
     microbit_panic(MICROBIT_HEAP_ERROR);
 }
@@ -408,4 +503,12 @@ int microbit_create_heap(uint32_t start, uint32_t end)
     return MICROBIT_OK;
 }
 
+int microbit_create_irq_heap(uint32_t start, uint32_t end)
+{
+    (void) start;
+    (void) end;
+
+    return MICROBIT_NOT_SUPPORTED;
+}
+
 #endif
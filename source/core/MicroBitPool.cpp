@@ -0,0 +1,214 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 British Broadcasting Corporation.
+This software is provided by Lancaster University by arrangement with the BBC.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+  * Fixed size block pools for the payloads of the managed types.
+  *
+  * Each pool is a static array of equally sized blocks, with a bitmap recording which
+  * are in use. Allocation takes the lowest free block of the smallest pool that fits,
+  * and release identifies the pool from the address alone, so neither has to search
+  * the heap. Anything the pools cannot serve is passed to malloc() and free().
+  */
+#include "MicroBitConfig.h"
+#include "MicroBitPool.h"
+#include "MicroBitDevice.h"
+#include "ErrorNo.h"
+
+#if CONFIG_ENABLED(MICROBIT_POOL_ENABLED)
+
+#if MICROBIT_POOL_SMALL_BLOCKS > 32 || MICROBIT_POOL_MEDIUM_BLOCKS > 32 || MICROBIT_POOL_LARGE_BLOCKS > 32
+#error "A MicroBitPool may hold at most 32 blocks"
+#endif
+
+#if (MICROBIT_POOL_SMALL_SIZE % 4) || (MICROBIT_POOL_MEDIUM_SIZE % 4) || (MICROBIT_POOL_LARGE_SIZE % 4)
+#error "MicroBitPool block sizes must be a multiple of 4 bytes"
+#endif
+
+#if MICROBIT_POOL_SMALL_SIZE >= MICROBIT_POOL_MEDIUM_SIZE || MICROBIT_POOL_MEDIUM_SIZE >= MICROBIT_POOL_LARGE_SIZE
+#error "MicroBitPool block sizes must be in increasing order"
+#endif
+
+// Storage for each pool. Declared as words so that every block is word aligned.
+static uint32_t pool_small[MICROBIT_POOL_SMALL_SIZE * MICROBIT_POOL_SMALL_BLOCKS / 4];
+static uint32_t pool_medium[MICROBIT_POOL_MEDIUM_SIZE * MICROBIT_POOL_MEDIUM_BLOCKS / 4];
+static uint32_t pool_large[MICROBIT_POOL_LARGE_SIZE * MICROBIT_POOL_LARGE_BLOCKS / 4];
+
+struct MicroBitPool
+{
+    uint8_t *start;             // The first block of the pool.
+    uint8_t *end;               // The first byte beyond the last block of the pool.
+    uint32_t used;              // A bitmap of allocated blocks. Bit n is set if block n is in use.
+    MicroBitPoolStats stats;    // Usage statistics.
+};
+
+static MicroBitPool pools[MICROBIT_POOL_CLASSES] = {
+    { (uint8_t *)pool_small, (uint8_t *)pool_small + sizeof(pool_small), 0, { MICROBIT_POOL_SMALL_SIZE, MICROBIT_POOL_SMALL_BLOCKS, 0, 0, 0, 0 } },
+    { (uint8_t *)pool_medium, (uint8_t *)pool_medium + sizeof(pool_medium), 0, { MICROBIT_POOL_MEDIUM_SIZE, MICROBIT_POOL_MEDIUM_BLOCKS, 0, 0, 0, 0 } },
+    { (uint8_t *)pool_large, (uint8_t *)pool_large + sizeof(pool_large), 0, { MICROBIT_POOL_LARGE_SIZE, MICROBIT_POOL_LARGE_BLOCKS, 0, 0, 0, 0 } }
+};
+
+/**
+  * Allocates a block of memory, from a pool if a suitable block is free, or from the heap otherwise.
+  *
+  * @param size The amount of memory, in bytes, to allocate.
+  *
+  * @return A pointer to the allocated memory, or NULL if insufficient memory is available.
+  *
+  * @note Memory returned by this function must be released with microbit_pool_free().
+  */
+void *microbit_pool_alloc(size_t size)
+{
+    int c = 0;
+
+    while (c < MICROBIT_POOL_CLASSES && size > pools[c].stats.blockSize)
+        c++;
+
+    // Too large for any pool.
+    if (c == MICROBIT_POOL_CLASSES)
+        return malloc(size);
+
+    MicroBitPool &pool = pools[c];
+    uint32_t mask = pool.stats.blocks < 32 ? (1UL << pool.stats.blocks) - 1 : 0xffffffff;
+
+    __disable_irq();
+
+    uint32_t avail = ~pool.used & mask;
+
+    if (avail == 0)
+    {
+        pool.stats.misses++;
+        __enable_irq();
+
+        return malloc(size);
+    }
+
+    // Take the lowest free block: (avail & -avail) isolates its bit.
+    uint32_t bit = avail & (0 - avail);
+    int index = 0;
+
+    if (!(bit & 0x0000ffff)) index += 16;
+    if (!(bit & 0x00ff00ff)) index += 8;
+    if (!(bit & 0x0f0f0f0f)) index += 4;
+    if (!(bit & 0x33333333)) index += 2;
+    if (!(bit & 0x55555555)) index += 1;
+
+    pool.used |= bit;
+    pool.stats.used++;
+    pool.stats.hits++;
+
+    if (pool.stats.used > pool.stats.peak)
+        pool.stats.peak = pool.stats.used;
+
+    __enable_irq();
+
+    return pool.start + index * pool.stats.blockSize;
+}
+
+/**
+  * Releases a block of memory obtained from microbit_pool_alloc(), returning it to its pool
+  * or to the heap as appropriate.
+  *
+  * @param p The memory to release. May be NULL.
+  */
+void microbit_pool_free(void *p)
+{
+    uint8_t *block = (uint8_t *)p;
+
+    for (int c = 0; c < MICROBIT_POOL_CLASSES; c++)
+    {
+        MicroBitPool &pool = pools[c];
+
+        if (block >= pool.start && block < pool.end)
+        {
+            uint32_t offset = block - pool.start;
+            uint32_t bit = 1UL << (offset / pool.stats.blockSize);
+
+            // Sanity check. The pointer must be the start of a block that is in use.
+            if (offset % pool.stats.blockSize != 0 || !(pool.used & bit))
+                microbit_panic(MICROBIT_HEAP_ERROR);
+
+            __disable_irq();
+            pool.used &= ~bit;
+            pool.stats.used--;
+            __enable_irq();
+
+            return;
+        }
+    }
+
+    free(p);
+}
+
+/**
+  * Reads the usage statistics for a given pool.
+  *
+  * @param sizeClass The pool to query, in the range 0..MICROBIT_POOL_CLASSES-1, smallest first.
+  *
+  * @param stats The structure to fill in.
+  *
+  * @return MICROBIT_OK on success, MICROBIT_INVALID_PARAMETER if sizeClass is out of range,
+  *         or MICROBIT_NOT_SUPPORTED if pools are disabled.
+  */
+int microbit_pool_stats(int sizeClass, MicroBitPoolStats *stats)
+{
+    if (sizeClass < 0 || sizeClass >= MICROBIT_POOL_CLASSES || stats == NULL)
+        return MICROBIT_INVALID_PARAMETER;
+
+    __disable_irq();
+    *stats = pools[sizeClass].stats;
+    __enable_irq();
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Resets the peak, hit and miss counters of all pools.
+  */
+void microbit_pool_reset_stats()
+{
+    __disable_irq();
+
+    for (int c = 0; c < MICROBIT_POOL_CLASSES; c++)
+    {
+        pools[c].stats.peak = pools[c].stats.used;
+        pools[c].stats.hits = 0;
+        pools[c].stats.misses = 0;
+    }
+
+    __enable_irq();
+}
+
+#else
+
+int microbit_pool_stats(int, MicroBitPoolStats *)
+{
+    return MICROBIT_NOT_SUPPORTED;
+}
+
+void microbit_pool_reset_stats()
+{
+}
+
+#endif
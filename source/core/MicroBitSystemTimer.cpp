@@ -30,30 +30,216 @@ DEALINGS IN THE SOFTWARE.
   *
   * 1) a concept of global system time since power up
   * 2) a simple periodic multiplexing API for the underlying mbed implementation.
+  * 3) a queue of one-shot and periodic callbacks, sorted by deadline and driven by a single hardware timer.
   *
-  * The latter is useful to avoid costs associated with multiple mbed Ticker instances
+  * The latter two are useful to avoid costs associated with multiple mbed Ticker instances
   * in microbit-dal components, as each incurs a significant additional RAM overhead (circa 80 bytes).
   */
 #include "MicroBitConfig.h"
 #include "MicroBitSystemTimer.h"
+#include "EventModel.h"
 #include "ErrorNo.h"
 
 /*
- * Time since power on. Measured in milliseconds.
- * When stored as an unsigned long, this gives us approx 50 days between rollover, which is ample. :-)
+ * Time since power on is derived from the free running mbed us_ticker, which is never reset.
+ * We record the most recent reading, and the number of times the 32 bit counter has wrapped,
+ * to extend it to 64 bits. The system tick ensures we sample it well within each wrap period (~71 minutes).
  */
-static uint64_t time_us = 0;
+static uint32_t time_us_low = 0;
+static uint32_t time_us_high = 0;
 static unsigned int tick_period = 0;
 
 // Array of components which are iterated during a system tick
 static MicroBitComponent* systemTickComponents[MICROBIT_SYSTEM_COMPONENTS];
 
-// Periodic callback interrupt
-static Ticker *ticker = NULL;
+// The period at which each component would like to be called (ms), or zero for every tick.
+static uint16_t systemTickPeriod[MICROBIT_SYSTEM_COMPONENTS];
 
-// System timer.
-static Timer *timer = NULL;
+// The time elapsed since each component was last called (ms).
+static uint16_t systemTickElapsed[MICROBIT_SYSTEM_COMPONENTS];
 
+#if CONFIG_ENABLED(MICROBIT_SYSTEM_TICK_PROFILING)
+// The total and worst case time spent in each component's systemTick() (us).
+static uint32_t systemTickTotalTime[MICROBIT_SYSTEM_COMPONENTS];
+static uint32_t systemTickMaxTime[MICROBIT_SYSTEM_COMPONENTS];
+#endif
+
+// The single hardware timer interrupt used to drive the timer queue.
+static Timeout *ticker = NULL;
+
+// Queue of pending timer events, sorted by deadline.
+static MicroBitSystemTimerEvent *timerQueue = NULL;
+
+/**
+  * Adapter to allow system_timer_tick() to be driven by the timer queue.
+  */
+static void system_timer_tick_handler(void *)
+{
+    system_timer_tick();
+}
+
+// The timer event used to drive the periodic system tick. Created on first use, as components
+// may start the timer from their own static constructors, before ours would have run.
+static MicroBitSystemTimerEvent *tickEvent = NULL;
+
+/**
+  * Determines the current time in microseconds, modulo 2^32. Used to calculate timer queue deadlines.
+  */
+static inline uint32_t timer_queue_now()
+{
+    return us_ticker_read();
+}
+
+/**
+  * Adds the given event to the timer queue, in deadline order.
+  * Must be called with interrupts disabled.
+  */
+static void timer_queue_insert(MicroBitSystemTimerEvent *evt)
+{
+    MicroBitSystemTimerEvent **p = &timerQueue;
+
+    // Events with the same deadline are called in the order they were scheduled.
+    while (*p != NULL && (int32_t)((*p)->timestamp - evt->timestamp) <= 0)
+        p = &(*p)->next;
+
+    evt->next = *p;
+    *p = evt;
+}
+
+/**
+  * Removes the given event from the timer queue, if present.
+  * Must be called with interrupts disabled.
+  *
+  * @return true if the event was found and removed, false otherwise.
+  */
+static bool timer_queue_remove(MicroBitSystemTimerEvent *evt)
+{
+    MicroBitSystemTimerEvent **p = &timerQueue;
+
+    while (*p != NULL && *p != evt)
+        p = &(*p)->next;
+
+    if (*p == NULL)
+        return false;
+
+    *p = evt->next;
+    evt->next = NULL;
+
+    return true;
+}
+
+static void timer_queue_irq();
+
+/**
+  * Programs the hardware timer to interrupt when the event at the head of the queue is due.
+  */
+static void timer_queue_reschedule()
+{
+    __disable_irq();
+
+    if (timerQueue == NULL)
+    {
+        ticker->detach();
+    }
+    else
+    {
+        int32_t delay = (int32_t)(timerQueue->timestamp - timer_queue_now());
+        ticker->attach_us(timer_queue_irq, delay > 0 ? delay : 0);
+    }
+
+    __enable_irq();
+}
+
+/**
+  * Timer queue interrupt handler. Invokes all events whose deadline has passed, in deadline order,
+  * requeues any periodic events, and then programs the hardware timer for the next deadline.
+  */
+static void timer_queue_irq()
+{
+    uint32_t now = timer_queue_now();
+
+    __disable_irq();
+
+    while (timerQueue != NULL && (int32_t)(now - timerQueue->timestamp) >= 0)
+    {
+        MicroBitSystemTimerEvent *evt = timerQueue;
+        uint32_t lateness = now - evt->timestamp;
+
+        timerQueue = evt->next;
+        evt->next = NULL;
+
+        if (lateness > evt->maxLateness)
+            evt->maxLateness = lateness;
+
+        // Periodic events are requeued before their callback, so that they may cancel themselves.
+        if (evt->period)
+        {
+            evt->timestamp += evt->period;
+
+            // If we've fallen more than a whole period behind, skip the deadlines we've missed rather than bursting.
+            if ((int32_t)(now - evt->timestamp) >= 0)
+            {
+                uint32_t missed = (now - evt->timestamp) / evt->period + 1;
+
+                evt->overruns += missed;
+                evt->timestamp += missed * evt->period;
+            }
+
+            timer_queue_insert(evt);
+        }
+
+        __enable_irq();
+        evt->cb(evt->cb_arg);
+        __disable_irq();
+
+        now = timer_queue_now();
+    }
+
+    __enable_irq();
+
+    timer_queue_reschedule();
+}
+
+/**
+  * Schedules the given event, replacing any existing schedule for it.
+  *
+  * @param evt The event to schedule.
+  *
+  * @param interval_us The time from now until the callback is due, in microseconds.
+  *
+  * @param period_us The period between callbacks in microseconds, or zero for a single callback.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if evt is NULL or has no handler.
+  */
+static int timer_queue_schedule(MicroBitSystemTimerEvent *evt, uint32_t interval_us, uint32_t period_us)
+{
+    bool head;
+
+    if (evt == NULL || evt->cb == NULL)
+        return MICROBIT_INVALID_PARAMETER;
+
+    // If we haven't been initialized, bring up the timer with the default period.
+    if (ticker == NULL)
+        system_timer_init(SYSTEM_TICK_PERIOD_MS);
+
+    // The entry is completely filled in before it is queued, as the timer interrupt may service it at any time after.
+    __disable_irq();
+
+    timer_queue_remove(evt);
+    evt->period = period_us;
+    evt->timestamp = timer_queue_now() + interval_us;
+    timer_queue_insert(evt);
+
+    head = timerQueue == evt;
+
+    __enable_irq();
+
+    // Only the head of the queue needs the hardware timer.
+    if (head)
+        timer_queue_reschedule();
+
+    return MICROBIT_OK;
+}
 
 /**
   * Initialises a system wide timer, used to drive the various components used in the runtime.
@@ -67,13 +253,7 @@ static Timer *timer = NULL;
 int system_timer_init(int period)
 {
     if (ticker == NULL)
-        ticker = new Ticker();
-
-    if (timer == NULL)
-    {
-        timer = new Timer();
-        timer->start();
-    }
+        ticker = new Timeout();
 
     return system_timer_set_period(period);
 }
@@ -90,15 +270,14 @@ int system_timer_set_period(int period)
     if (period < 1)
         return MICROBIT_INVALID_PARAMETER;
 
-    // If a timer is already running, ensure it is disabled before reconfiguring.
-    if (tick_period)
-        ticker->detach();
-
 	// register a period callback to drive the scheduler and any other registered components.
+    // Any existing tick is replaced, as the event is removed from the queue before being rescheduled.
     tick_period = period;
-    ticker->attach_us(system_timer_tick, period * 1000);
 
-    return MICROBIT_OK;
+    if (tickEvent == NULL)
+        tickEvent = new MicroBitSystemTimerEvent(system_timer_tick_handler);
+
+    return system_timer_event_every_us(tickEvent, period * 1000);
 }
 
 /**
@@ -114,17 +293,31 @@ int system_timer_get_period()
 /**
   * Updates the current time in microseconds, since power on.
   *
-  * If the mbed Timer hasn't been initialised, it will be initialised
+  * The time is read from the free running mbed us_ticker, which is never reset, and
+  * extended to 64 bits by counting the times it has wrapped.
+  *
+  * If the system timer hasn't been initialised, it will be initialised
   * on the first call to this function.
   */
 void update_time()
 {
     // If we haven't been initialized, bring up the timer with the default period.
-    if (timer == NULL || ticker == NULL)
+    if (ticker == NULL)
         system_timer_init(SYSTEM_TICK_PERIOD_MS);
 
-    time_us += timer->read_us();
-    timer->reset();
+    // We may be called from within another critical section, so restore the interrupt state we found.
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t now = us_ticker_read();
+
+    // The hardware counter has wrapped since we last looked.
+    if (now < time_us_low)
+        time_us_high++;
+
+    time_us_low = now;
+
+    __set_PRIMASK(primask);
 }
 
 /**
@@ -144,8 +337,17 @@ uint64_t system_timer_current_time()
   */
 uint64_t system_timer_current_time_us()
 {
+    uint64_t t;
+
     update_time();
-    return time_us;
+
+    // Take a consistent snapshot, in case an interrupt updates the time between reading each half.
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    t = ((uint64_t)time_us_high << 32) | time_us_low;
+    __set_PRIMASK(primask);
+
+    return t;
 }
 
 /**
@@ -158,28 +360,61 @@ void system_timer_tick()
 {
     update_time();
 
-    // Update any components registered for a callback
+    // Update any components registered for a callback, that are due one.
     for(int i = 0; i < MICROBIT_SYSTEM_COMPONENTS; i++)
-        if(systemTickComponents[i] != NULL)
-            systemTickComponents[i]->systemTick();
+    {
+        if(systemTickComponents[i] == NULL)
+            continue;
+
+        if(systemTickPeriod[i])
+        {
+            systemTickElapsed[i] += tick_period;
+
+            if(systemTickElapsed[i] < systemTickPeriod[i])
+                continue;
+
+            // Carry any remainder forward, so that the average rate matches the requested period.
+            systemTickElapsed[i] -= systemTickPeriod[i];
+            if(systemTickElapsed[i] >= systemTickPeriod[i])
+                systemTickElapsed[i] = 0;
+        }
+
+#if CONFIG_ENABLED(MICROBIT_SYSTEM_TICK_PROFILING)
+        uint32_t start = us_ticker_read();
+        systemTickComponents[i]->systemTick();
+        uint32_t duration = us_ticker_read() - start;
+
+        systemTickTotalTime[i] += duration;
+        if(duration > systemTickMaxTime[i])
+            systemTickMaxTime[i] = duration;
+#else
+        systemTickComponents[i]->systemTick();
+#endif
+    }
 }
 
 /**
   * Add a component to the array of system components. This component will then receive
-  * periodic callbacks, once every tick period.
+  * periodic callbacks, once every tick period, or at the nearest tick to the given period.
   *
   * @param component The component to add.
   *
-  * @return MICROBIT_OK on success. MICROBIT_NO_RESOURCES is returned if the component array is full.
+  * @param period The interval between callbacks in milliseconds, or zero to be called on every tick. Defaults to zero.
+  *
+  * @return MICROBIT_OK on success. MICROBIT_NO_RESOURCES is returned if the component array is full,
+  *         or MICROBIT_INVALID_PARAMETER if the period is out of range.
   *
   * @note The callback will be in interrupt context.
   */
-int system_timer_add_component(MicroBitComponent *component)
+int system_timer_add_component(MicroBitComponent *component, int period)
 {
+    if (period < 0 || period > 0xffff)
+        return MICROBIT_INVALID_PARAMETER;
+
     int i = 0;
 
     // If we haven't been initialized, bring up the timer with the default period.
-    if (timer == NULL || ticker == NULL)
+    if (ticker == NULL)
         system_timer_init(SYSTEM_TICK_PERIOD_MS);
 
     while(systemTickComponents[i] != NULL && i < MICROBIT_SYSTEM_COMPONENTS)
@@ -188,6 +423,14 @@ int system_timer_add_component(MicroBitComponent *component)
     if(i == MICROBIT_SYSTEM_COMPONENTS)
         return MICROBIT_NO_RESOURCES;
 
+    systemTickPeriod[i] = period;
+    systemTickElapsed[i] = 0;
+
+#if CONFIG_ENABLED(MICROBIT_SYSTEM_TICK_PROFILING)
+    systemTickTotalTime[i] = 0;
+    systemTickMaxTime[i] = 0;
+#endif
+
     systemTickComponents[i] = component;
     return MICROBIT_OK;
 }
@@ -214,3 +457,235 @@ int system_timer_remove_component(MicroBitComponent *component)
 
     return MICROBIT_OK;
 }
+
+/**
+  * Retrieves the time spent in interrupt context by a given component's systemTick() callback.
+  *
+  * @param component The component to query.
+  *
+  * @param total_us If not NULL, set to the total time spent in the callback since the component was added, in microseconds.
+  *
+  * @param max_us If not NULL, set to the longest single invocation of the callback, in microseconds.
+  *
+  * @return MICROBIT_OK on success, MICROBIT_INVALID_PARAMETER if the given component has not been previously added,
+  *         or MICROBIT_NOT_SUPPORTED if MICROBIT_SYSTEM_TICK_PROFILING is disabled.
+  */
+int system_timer_get_component_time(MicroBitComponent *component, uint32_t *total_us, uint32_t *max_us)
+{
+#if CONFIG_ENABLED(MICROBIT_SYSTEM_TICK_PROFILING)
+    int i = 0;
+
+    while(systemTickComponents[i] != component && i < MICROBIT_SYSTEM_COMPONENTS)
+        i++;
+
+    if(component == NULL || i == MICROBIT_SYSTEM_COMPONENTS)
+        return MICROBIT_INVALID_PARAMETER;
+
+    if(total_us)
+        *total_us = systemTickTotalTime[i];
+
+    if(max_us)
+        *max_us = systemTickMaxTime[i];
+
+    return MICROBIT_OK;
+#else
+    (void) component;
+    (void) total_us;
+    (void) max_us;
+
+    return MICROBIT_NOT_SUPPORTED;
+#endif
+}
+
+/**
+  * Schedules a single callback, the given number of microseconds from now.
+  * If the event is already scheduled, it is first removed from the queue.
+  *
+  * @param evt The event to schedule. This must remain valid until it has fired or has been cancelled.
+  *
+  * @param interval_us The time from now until the callback is due, in microseconds.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if evt is NULL or has no handler.
+  *
+  * @note The callback will be in interrupt context.
+  */
+int system_timer_event_after_us(MicroBitSystemTimerEvent *evt, uint32_t interval_us)
+{
+    return timer_queue_schedule(evt, interval_us, 0);
+}
+
+/**
+  * Schedules a periodic callback, first due one period from now.
+  * Deadlines advance by exactly one period each time, so callbacks do not drift.
+  * If the event is already scheduled, it is first removed from the queue.
+  *
+  * @param evt The event to schedule. This must remain valid until it has been cancelled.
+  *
+  * @param period_us The period between callbacks, in microseconds.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if evt is NULL, has no handler or period_us is zero.
+  *
+  * @note The callback will be in interrupt context.
+  */
+int system_timer_event_every_us(MicroBitSystemTimerEvent *evt, uint32_t period_us)
+{
+    if (period_us == 0)
+        return MICROBIT_INVALID_PARAMETER;
+
+    return timer_queue_schedule(evt, period_us, period_us);
+}
+
+/**
+  * Removes an event from the timer queue. Its callback will not be invoked again until it is rescheduled.
+  *
+  * @param evt The event to cancel.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the event was not scheduled.
+  */
+int system_timer_cancel_event(MicroBitSystemTimerEvent *evt)
+{
+    bool found;
+
+    if (evt == NULL)
+        return MICROBIT_INVALID_PARAMETER;
+
+    __disable_irq();
+    found = timer_queue_remove(evt);
+    __enable_irq();
+
+    // There's no need to reprogram the hardware. At worst, we'll take one spurious interrupt.
+    return found ? MICROBIT_OK : MICROBIT_INVALID_PARAMETER;
+}
+
+// The next message bus event value to assign to a periodic callback.
+static uint16_t periodicCallbackValue = 0;
+
+/**
+  * Records the lateness of a periodic callback that is about to be called.
+  */
+static void periodic_callback_account(MicroBitPeriodicCallback *cb)
+{
+    uint32_t lateness = us_ticker_read() - cb->deadline;
+
+    cb->calls++;
+    cb->totalLateness += lateness;
+
+    if (lateness > cb->maxLateness)
+        cb->maxLateness = lateness;
+}
+
+/**
+  * Message bus handler for periodic callbacks in SYSTEM_TIMER_CALLBACK_MESSAGE_BUS mode.
+  */
+static void periodic_callback_event(MicroBitEvent, void *arg)
+{
+    MicroBitPeriodicCallback *cb = (MicroBitPeriodicCallback *)arg;
+
+    periodic_callback_account(cb);
+    cb->pending = 0;
+
+    cb->fn();
+}
+
+/**
+  * Timer queue handler for all periodic callbacks. Called in interrupt context.
+  */
+static void periodic_callback_irq(void *arg)
+{
+    MicroBitPeriodicCallback *cb = (MicroBitPeriodicCallback *)arg;
+
+    // The event has already been requeued, so the deadline we're servicing is one period back.
+    cb->deadline = cb->timestamp - cb->period;
+
+    if (cb->mode == SYSTEM_TIMER_CALLBACK_IRQ)
+    {
+        periodic_callback_account(cb);
+        cb->fn();
+        return;
+    }
+
+    // Don't let a slow handler fill the message bus queue.
+    if (cb->pending)
+    {
+        cb->overruns++;
+        return;
+    }
+
+    MicroBitEvent evt(MICROBIT_ID_SYSTEM_TIMER, cb->value, CREATE_ONLY_NO_TIMESTAMP);
+
+    // If the message bus drops the event, nothing will ever clear the flag, so count the period as missed
+    // and let the next one try again.
+    cb->pending = 1;
+
+    if (EventModel::defaultEventBus == NULL || EventModel::defaultEventBus->send(evt) != MICROBIT_OK)
+    {
+        cb->pending = 0;
+        cb->overruns++;
+    }
+}
+
+/**
+  * Calls the given function periodically, without requiring a fiber.
+  *
+  * Deadlines are calculated from the time of registration, so calls do not drift however long the callback takes.
+  * If a call is more than a whole period late, missed calls are skipped and counted as overruns rather than
+  * being delivered in a burst. In SYSTEM_TIMER_CALLBACK_MESSAGE_BUS mode, a period is also counted as an overrun
+  * if the previous call is still waiting on the message bus.
+  *
+  * @param period_us The period between calls, in microseconds.
+  *
+  * @param callback The function to call.
+  *
+  * @param mode The context in which to call the function. Defaults to SYSTEM_TIMER_CALLBACK_IRQ.
+  *
+  * @return A handle that records lateness statistics and may be passed to system_timer_cancel_every(),
+  *         or NULL if the parameters are invalid or insufficient resources are available.
+  */
+MicroBitPeriodicCallback *system_timer_every(uint32_t period_us, void (*callback)(void), SystemTimerCallbackMode mode)
+{
+    if (period_us == 0 || callback == NULL)
+        return NULL;
+
+    if (mode == SYSTEM_TIMER_CALLBACK_MESSAGE_BUS && EventModel::defaultEventBus == NULL)
+        return NULL;
+
+    MicroBitPeriodicCallback *cb = new MicroBitPeriodicCallback(periodic_callback_irq);
+
+    if (cb == NULL)
+        return NULL;
+
+    cb->fn = callback;
+    cb->mode = mode;
+    cb->value = ++periodicCallbackValue;
+
+    // Zero is MICROBIT_EVT_ANY, so never hand it out.
+    if (cb->value == 0)
+        cb->value = ++periodicCallbackValue;
+
+    if (mode == SYSTEM_TIMER_CALLBACK_MESSAGE_BUS)
+        EventModel::defaultEventBus->listen(MICROBIT_ID_SYSTEM_TIMER, cb->value, periodic_callback_event, cb, MESSAGE_BUS_LISTENER_NONBLOCKING);
+
+    system_timer_event_every_us(cb, period_us);
+
+    return cb;
+}
+
+/**
+  * Stops and releases a periodic callback created by system_timer_every().
+  *
+  * @param cb The handle returned by system_timer_every().
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the callback is not active.
+  */
+int system_timer_cancel_every(MicroBitPeriodicCallback *cb)
+{
+    if (system_timer_cancel_event(cb) != MICROBIT_OK)
+        return MICROBIT_INVALID_PARAMETER;
+
+    if (cb->mode == SYSTEM_TIMER_CALLBACK_MESSAGE_BUS && EventModel::defaultEventBus)
+        EventModel::defaultEventBus->ignore(MICROBIT_ID_SYSTEM_TIMER, cb->value, periodic_callback_event, cb);
+
+    delete cb;
+
+    return MICROBIT_OK;
+}
@@ -52,7 +52,7 @@ MicroBitButton::MicroBitButton(PinName name, uint16_t id, MicroBitButtonEventCon
     this->eventConfiguration = eventConfiguration;
     this->downStartTime = 0;
     this->sigma = 0;
-    system_timer_add_component(this);
+    system_timer_add_component(this, MICROBIT_BUTTON_SAMPLE_PERIOD);
 }
 
 /**
@@ -35,7 +35,48 @@ DEALINGS IN THE SOFTWARE.
 #include "ErrorNo.h"
 #include "NotifyEvents.h"
 
-const int greyScaleTimings[MICROBIT_DISPLAY_GREYSCALE_BIT_DEPTH] = {1, 23, 70, 163, 351, 726, 1476, 2976};
+// The time each greyscale slot is lit for (us). The first shows the dithered short bit plane,
+// for as long as the first long plane, and the rest show the long planes in turn.
+const int greyScaleTimings[MICROBIT_DISPLAY_GREYSCALE_SLOTS] = {163, 163, 351, 726, 1476, 2976};
+
+#if CONFIG_ENABLED(MICROBIT_DISPLAY_GAMMA_CORRECTION)
+// Relative LED on time for each pixel or brightness value, scaled to 16 bits, such that
+// equal steps in value give equal steps in perceived (CIE 1931) lightness.
+static const uint16_t gammaTable[256] = {
+        0,    28,    57,    85,   114,   142,   171,   199,   228,   256,   285,   313,   341,   370,   398,   427,
+      455,   484,   512,   541,   569,   598,   627,   658,   689,   721,   755,   789,   825,   861,   899,   937,
+      977,  1018,  1060,  1103,  1147,  1192,  1239,  1287,  1336,  1386,  1437,  1490,  1544,  1599,  1656,  1714,
+     1773,  1834,  1896,  1959,  2024,  2090,  2157,  2226,  2297,  2369,  2442,  2517,  2593,  2671,  2751,  2832,
+     2914,  2999,  3085,  3172,  3261,  3352,  3444,  3538,  3634,  3732,  3831,  3932,  4035,  4139,  4245,  4354,
+     4464,  4575,  4689,  4804,  4922,  5041,  5162,  5285,  5410,  5537,  5666,  5797,  5930,  6065,  6202,  6341,
+     6482,  6626,  6771,  6918,  7068,  7220,  7373,  7529,  7687,  7848,  8010,  8175,  8342,  8512,  8683,  8857,
+     9033,  9212,  9393,  9576,  9762,  9949, 10140, 10333, 10528, 10725, 10926, 11128, 11333, 11541, 11751, 11963,
+    12179, 12396, 12617, 12840, 13065, 13293, 13524, 13757, 13993, 14232, 14474, 14718, 14965, 15215, 15467, 15722,
+    15980, 16241, 16505, 16771, 17041, 17313, 17588, 17866, 18147, 18431, 18717, 19007, 19300, 19596, 19894, 20196,
+    20501, 20809, 21119, 21433, 21750, 22071, 22394, 22720, 23050, 23383, 23719, 24058, 24400, 24746, 25095, 25447,
+    25802, 26161, 26523, 26888, 27257, 27629, 28004, 28383, 28765, 29151, 29540, 29932, 30328, 30728, 31131, 31537,
+    31947, 32360, 32777, 33198, 33622, 34050, 34481, 34916, 35355, 35797, 36243, 36693, 37146, 37603, 38064, 38529,
+    38997, 39469, 39945, 40425, 40908, 41396, 41887, 42382, 42881, 43384, 43891, 44401, 44916, 45435, 45957, 46484,
+    47015, 47549, 48088, 48631, 49178, 49728, 50283, 50843, 51406, 51973, 52545, 53120, 53700, 54284, 54873, 55465,
+    56062, 56663, 57269, 57878, 58492, 59111, 59733, 60360, 60992, 61627, 62268, 62912, 63561, 64215, 64873, 65535,
+};
+#endif
+
+/**
+  * Maps a pixel value onto the intensity shown in greyscale mode, in the range
+  * 0 to (1 << MICROBIT_DISPLAY_GREYSCALE_BIT_DEPTH) - 1.
+  */
+static inline int greyscale_intensity(int value)
+{
+#if CONFIG_ENABLED(MICROBIT_DISPLAY_GAMMA_CORRECTION)
+    int intensity = gammaTable[value] >> (16 - MICROBIT_DISPLAY_GREYSCALE_BIT_DEPTH);
+#else
+    int intensity = ((value << 8) | value) >> (16 - MICROBIT_DISPLAY_GREYSCALE_BIT_DEPTH);
+#endif
+
+    // Keep the dimmest levels visible, rather than rounding them away.
+    return (value && !intensity) ? 1 : intensity;
+}
 
 /**
   * Constructor.
@@ -53,6 +94,7 @@ const int greyScaleTimings[MICROBIT_DISPLAY_GREYSCALE_BIT_DEPTH] = {1, 23, 70, 1
   * @endcode
   */
 MicroBitDisplay::MicroBitDisplay(uint16_t id, const MatrixMap &map) :
+    renderTimer(system_timer_method_call<MicroBitDisplay, &MicroBitDisplay::renderFinish>, this),
     matrixMap(map),
     image(map.width*2,map.height)
 {
@@ -76,7 +118,24 @@ MicroBitDisplay::MicroBitDisplay(uint16_t id, const MatrixMap &map) :
 
     LEDMatrix = new PortOut(Port0, row_mask | col_mask);
 
-    this->greyscaleBitMsk = 0x01;
+    this->pixelMap = new uint16_t[matrixMap.rows * matrixMap.columns];
+    this->frameData = new uint32_t[matrixMap.rows * MICROBIT_DISPLAY_FRAME_WORDS];
+    this->frameMode = 0xFF;
+    this->compiledBitmap = NULL;
+    this->compiledWriteCount = 0;
+    this->frameDirty = true;
+    this->greyscaleFrame = 0;
+    this->swapPending = false;
+    this->scrollingStrip = NULL;
+    this->scrollingStripLength = 0;
+    this->scrollingStripCapacity = 0;
+    this->scrollingCharWidth = width;
+    this->proportionalText = MICROBIT_DISPLAY_PROPORTIONAL_TEXT;
+    this->playlist = NULL;
+    this->playlistHead = 0;
+    this->playlistCount = 0;
+    this->compilePixelMap();
+
     this->timingCount = 0;
     this->setBrightness(MICROBIT_DISPLAY_DEFAULT_BRIGHTNESS);
     this->mode = DISPLAY_MODE_BLACK_AND_WHITE;
@@ -112,12 +171,13 @@ void MicroBitDisplay::systemTick()
     if(strobeRow == matrixMap.rows)
         strobeRow = 0;
 
+    this->frameUpdate();
+
     if(mode == DISPLAY_MODE_BLACK_AND_WHITE)
         render();
 
     if(mode == DISPLAY_MODE_GREYSCALE)
     {
-        greyscaleBitMsk = 0x01;
         timingCount = 0;
         renderGreyscale();
     }
@@ -131,59 +191,182 @@ void MicroBitDisplay::renderFinish()
     *LEDMatrix = 0;
 }
 
-void MicroBitDisplay::render()
+/**
+  * Rebuilds the table of bitmap offsets used to compile each frame, taking into account
+  * the current rotation. Entries are stored in strobe order: all the columns of row 0, then row 1...
+  */
+void MicroBitDisplay::compilePixelMap()
 {
-    // Simple optimisation.
-    // If display is at zero brightness, there's nothing to do.
-    if(brightness == 0)
+    uint16_t *p = pixelMap;
+
+    for (int r = 0; r < matrixMap.rows; r++)
     {
-        renderFinish();
-        return;
+        for (int i = 0; i < matrixMap.columns; i++)
+        {
+            int index = (i * matrixMap.rows) + r;
+
+            int x = matrixMap.map[index].x;
+            int y = matrixMap.map[index].y;
+            int t = x;
+
+            if(rotation == MICROBIT_DISPLAY_ROTATION_90)
+            {
+                    x = width - 1 - y;
+                    y = t;
+            }
+
+            if(rotation == MICROBIT_DISPLAY_ROTATION_180)
+            {
+                    x = width - 1 - x;
+                    y = height - 1 - y;
+            }
+
+            if(rotation == MICROBIT_DISPLAY_ROTATION_270)
+            {
+                    x = y;
+                    y = height - 1 - t;
+            }
+
+            *p++ = y * (width * 2) + x;
+        }
     }
+}
 
-    // Calculate the bitpattern to write.
-    uint32_t row_data = 0x01 << (matrixMap.rowStart + strobeRow);
-    uint32_t col_data = 0;
+/**
+  * Translates the current image into the words written to LEDMatrix for each row.
+  *
+  * In greyscale mode, one word is generated for each greyscale slot of each row, with the pixel values
+  * already limited by the current brightness and mapped onto their intensity. Otherwise only the first
+  * word of each row is used.
+  *
+  * The least significant bit plane is shorter than the timer can resolve, so is not shown individually.
+  * Instead, the first slot of each row is lit for the duration of the first long plane on one of
+  * every pair of frames. Dithering over any more frames than this would flicker visibly, which is
+  * why no further bit planes are shown. Both phases are compiled here, so alternating between them
+  * needs no work in the tick.
+  */
+void MicroBitDisplay::compileFrame()
+{
+    const uint8_t *bitmap = image.getBitmap();
+    const uint16_t *p = pixelMap;
+    uint32_t *frame = frameData;
+    uint8_t compiledMode = mode;
 
-    for (int i = 0; i < matrixMap.columns; i++)
+    for (int r = 0; r < matrixMap.rows; r++)
     {
-        int index = (i * matrixMap.rows) + strobeRow;
-
-        int x = matrixMap.map[index].x;
-        int y = matrixMap.map[index].y;
-        int t = x;
+        uint32_t row_data = 0x01 << (matrixMap.rowStart + r);
+        uint32_t col_data[MICROBIT_DISPLAY_FRAME_WORDS];
 
-        if(rotation == MICROBIT_DISPLAY_ROTATION_90)
+        if(compiledMode == DISPLAY_MODE_GREYSCALE)
         {
-                x = width - 1 - y;
-                y = t;
-        }
+            memset(col_data, 0, sizeof(col_data));
+
+            for (int i = 0; i < matrixMap.columns; i++)
+            {
+                int value = greyscale_intensity(min(bitmap[*p++], brightness));
+
+                // The short bit plane lights the first slot on even frames only, so its alternate phase stays dark.
+                if (value & 0x01)
+                    col_data[0] |= (1 << i);
 
-        if(rotation == MICROBIT_DISPLAY_ROTATION_180)
+                value >>= MICROBIT_DISPLAY_GREYSCALE_SHORT_PLANES;
+
+                for (int s = 1; value; s++, value >>= 1)
+                    if (value & 0x01)
+                        col_data[s] |= (1 << i);
+            }
+
+            // Invert column bits (as we're sinking not sourcing power), and mask off any unused bits.
+            for (int s = 0; s < MICROBIT_DISPLAY_FRAME_WORDS; s++)
+                frame[s] = (~col_data[s] << matrixMap.columnStart & col_mask) | row_data;
+        }
+        else
         {
-                x = width - 1 - x;
-                y = height - 1 - y;
+            col_data[0] = 0;
+
+            for (int i = 0; i < matrixMap.columns; i++)
+                if (bitmap[*p++])
+                    col_data[0] |= (1 << i);
+
+            frame[0] = (~col_data[0] << matrixMap.columnStart & col_mask) | row_data;
         }
 
-        if(rotation == MICROBIT_DISPLAY_ROTATION_270)
+        frame += MICROBIT_DISPLAY_FRAME_WORDS;
+    }
+
+    frameMode = compiledMode;
+}
+
+/**
+  * Called before each row is rendered. At the start of each refresh, presents any pending
+  * back buffer and compiles the next frame if it has changed.
+  *
+  * The image is considered changed if it now refers to a different bitmap, or if any image has
+  * been written through getMutableBitmap() since the last compile. As a writer may still be
+  * part way through an update when the frame is compiled, a frame compiled because of a write
+  * is always compiled once more on the following refresh.
+  */
+void MicroBitDisplay::frameUpdate()
+{
+    if(strobeRow == 0)
+    {
+        if(swapPending)
+            presentBackBuffer();
+
+        // Move on to the other dither phase of the greyscale frame.
+        greyscaleFrame++;
+
+        const uint8_t *bitmap = image.getBitmap();
+        uint32_t writes = MicroBitImage::writeCount;
+        bool written = writes != compiledWriteCount;
+
+        if(frameDirty || written || bitmap != compiledBitmap || frameMode != mode)
         {
-                x = y;
-                y = height - 1 - t;
-        }
+            frameDirty = written;
+            compiledWriteCount = writes;
+            compiledBitmap = bitmap;
 
-        if(image.getBitmap()[y*(width*2)+x])
-            col_data |= (1 << i);
+            compileFrame();
+        }
     }
+    else if(frameMode != mode)
+    {
+        compileFrame();
+    }
+}
+
+/**
+  * Exchanges the back buffer with the displayed image, and raises MICROBIT_DISPLAY_EVT_FRAME.
+  */
+void MicroBitDisplay::presentBackBuffer()
+{
+    // Only the bitmap pointers move, so nothing is copied or allocated in interrupt context.
+    image.swap(backBuffer);
+    swapPending = false;
+
+    MicroBitEvent(id, MICROBIT_DISPLAY_EVT_FRAME);
+}
 
-    // Invert column bits (as we're sinking not sourcing power), and mask off any unused bits.
-    col_data = ~col_data << matrixMap.columnStart & col_mask;
+void MicroBitDisplay::render()
+{
+    // Simple optimisation.
+    // If display is at zero brightness, there's nothing to do.
+    // The same applies to the extra dark row used for light sensing.
+    if(brightness == 0 || strobeRow >= matrixMap.rows)
+    {
+        renderFinish();
+        return;
+    }
 
-    // Write the new bit pattern
-    *LEDMatrix = col_data | row_data;
+    // Write the precompiled bit pattern for this row.
+    *LEDMatrix = frameData[strobeRow * MICROBIT_DISPLAY_FRAME_WORDS];
 
     //timer does not have enough resolution for brightness of 1. 23.53 us
     if(brightness != MICROBIT_DISPLAY_MAXIMUM_BRIGHTNESS && brightness > MICROBIT_DISPLAY_MINIMUM_BRIGHTNESS)
-        renderTimer.attach_us(this, &MicroBitDisplay::renderFinish, (((brightness * 950) / (MICROBIT_DISPLAY_MAXIMUM_BRIGHTNESS)) * system_timer_get_period()));
+    {
+        renderTimer.cb = system_timer_method_call<MicroBitDisplay, &MicroBitDisplay::renderFinish>;
+        system_timer_event_after_us(&renderTimer, brightnessDuty * system_timer_get_period());
+    }
 
     //this will take around 23us to execute
     if(brightness <= MICROBIT_DISPLAY_MINIMUM_BRIGHTNESS)
@@ -200,6 +383,8 @@ void MicroBitDisplay::renderWithLightSense()
     }
     else
     {
+        this->frameUpdate();
+
         render();
         this->animationUpdate();
 
@@ -219,58 +404,21 @@ void MicroBitDisplay::renderGreyscale()
         return;
     }
 
-    uint32_t row_data = 0x01 << (matrixMap.rowStart + strobeRow);
-    uint32_t col_data = 0;
-
-    // Calculate the bitpattern to write.
-    for (int i = 0; i < matrixMap.columns; i++)
+    // Each call lights the next slot of this row, until every slot has been shown.
+    if(timingCount >= MICROBIT_DISPLAY_GREYSCALE_SLOTS)
     {
-        int index = (i * matrixMap.rows) + strobeRow;
-
-        int x = matrixMap.map[index].x;
-        int y = matrixMap.map[index].y;
-        int t = x;
-
-        if(rotation == MICROBIT_DISPLAY_ROTATION_90)
-        {
-                x = width - 1 - y;
-                y = t;
-        }
-
-        if(rotation == MICROBIT_DISPLAY_ROTATION_180)
-        {
-                x = width - 1 - x;
-                y = height - 1 - y;
-        }
-
-        if(rotation == MICROBIT_DISPLAY_ROTATION_270)
-        {
-                x = y;
-                y = height - 1 - t;
-        }
-
-        if(min(image.getBitmap()[y * (width * 2) + x],brightness) & greyscaleBitMsk)
-            col_data |= (1 << i);
+        renderFinish();
+        return;
     }
 
-    // Invert column bits (as we're sinking not sourcing power), and mask off any unused bits.
-    col_data = ~col_data << matrixMap.columnStart & col_mask;
-
-    // Write the new bit pattern
-    *LEDMatrix = col_data | row_data;
+    // Write the precompiled bit pattern for this row and slot.
+    // The first slot alternates between its two dither phases on successive frames.
+    int slot = (timingCount == 0 && (greyscaleFrame & 0x01)) ? MICROBIT_DISPLAY_GREYSCALE_SLOTS : timingCount;
 
-    if(timingCount > MICROBIT_DISPLAY_GREYSCALE_BIT_DEPTH-1)
-        return;
+    *LEDMatrix = frameData[strobeRow * MICROBIT_DISPLAY_FRAME_WORDS + slot];
 
-    greyscaleBitMsk <<= 1;
-
-    if(timingCount < 3)
-    {
-        wait_us(greyScaleTimings[timingCount++]);
-        renderGreyscale();
-        return;
-    }
-    renderTimer.attach_us(this,&MicroBitDisplay::renderGreyscale, greyScaleTimings[timingCount++]);
+    renderTimer.cb = system_timer_method_call<MicroBitDisplay, &MicroBitDisplay::renderGreyscale>;
+    system_timer_event_after_us(&renderTimer, greyScaleTimings[timingCount++]);
 }
 
 /**
@@ -289,22 +437,34 @@ MicroBitDisplay::animationUpdate()
     {
         animationTick = 0;
 
-        if (animationMode == ANIMATION_MODE_SCROLL_TEXT)
-            this->updateScrollText();
-
-        if (animationMode == ANIMATION_MODE_PRINT_TEXT)
-            this->updatePrintText();
-
-        if (animationMode == ANIMATION_MODE_SCROLL_IMAGE)
-            this->updateScrollImage();
-
-        if (animationMode == ANIMATION_MODE_ANIMATE_IMAGE || animationMode == ANIMATION_MODE_ANIMATE_IMAGE_WITH_CLEAR)
-            this->updateAnimateImage();
-
-        if(animationMode == ANIMATION_MODE_PRINT_CHARACTER)
+        // Only update the animation that was running. Completing it may start the next item
+        // in the playlist, which must not be stepped until its own delay has passed.
+        switch (animationMode)
         {
-            animationMode = ANIMATION_MODE_NONE;
-            this->sendAnimationCompleteEvent();
+            case ANIMATION_MODE_SCROLL_TEXT:
+                this->updateScrollText();
+                break;
+
+            case ANIMATION_MODE_PRINT_TEXT:
+                this->updatePrintText();
+                break;
+
+            case ANIMATION_MODE_SCROLL_IMAGE:
+                this->updateScrollImage();
+                break;
+
+            case ANIMATION_MODE_ANIMATE_IMAGE:
+            case ANIMATION_MODE_ANIMATE_IMAGE_WITH_CLEAR:
+                this->updateAnimateImage();
+                break;
+
+            case ANIMATION_MODE_PRINT_CHARACTER:
+                animationMode = ANIMATION_MODE_NONE;
+                this->sendAnimationCompleteEvent();
+                break;
+
+            default:
+                break;
         }
     }
 }
@@ -315,11 +475,15 @@ MicroBitDisplay::animationUpdate()
   */
 void MicroBitDisplay::sendAnimationCompleteEvent()
 {
+    // If there's anything waiting in the playlist, move straight on to it without waking anyone.
+    if (playlistNext() == MICROBIT_OK)
+        return;
+
     // Signal that we've completed an animation.
     MicroBitEvent(id,MICROBIT_DISPLAY_EVT_ANIMATION_COMPLETE);
 
     // Wake up a fiber that was blocked on the animation (if any).
-    MicroBitEvent(MICROBIT_ID_NOTIFY_ONE, MICROBIT_DISPLAY_EVT_FREE);
+    MicroBitEvent(MICROBIT_ID_NOTIFY_ONE, MICROBIT_DISPLAY_EVT_FREE, CREATE_AND_FIRE_NO_TIMESTAMP);
 }
 
 /**
@@ -328,14 +492,44 @@ void MicroBitDisplay::sendAnimationCompleteEvent()
   */
 void MicroBitDisplay::updateScrollText()
 {
+    if (scrollingStripLength)
+    {
+        this->updateScrollStrip();
+        return;
+    }
+
     image.shiftLeft(1);
     scrollingPosition++;
 
-    if (scrollingPosition == width + MICROBIT_DISPLAY_SPACING)
+    if (scrollingPosition == scrollingCharWidth + MICROBIT_DISPLAY_SPACING)
     {
-        scrollingPosition = 0;
+        MicroBitGlyph glyph;
+        bool valid = scrollingChar < scrollingText.length() && MicroBitFont::systemFont.getGlyph(scrollingText.charAt(scrollingChar), &glyph) == MICROBIT_OK;
+
+        // Write the glyph's columns just off the right hand edge of the display. The trailing blank
+        // is always a full display wide, so that the last character scrolls completely out of view.
+        uint8_t *bitmap = image.getMutableBitmap();
+        int stride = image.getWidth();
+        int rows = min(height, MICROBIT_FONT_HEIGHT);
+        int first = 0;
+        int columns = min(width, MICROBIT_FONT_WIDTH);
+
+        if (valid && proportionalText)
+        {
+            first = glyph.offset;
+            columns = min(width, glyph.width);
+        }
 
-        image.print(scrollingChar < scrollingText.length() ? scrollingText.charAt(scrollingChar) : ' ',width,0);
+        for (int col = 0; col < columns; col++)
+        {
+            uint8_t column = valid ? glyph.columns[first + col] : 0;
+
+            for (int y = 0; y < rows; y++)
+                bitmap[y * stride + width + col] = (column & (1 << y)) ? 255 : 0;
+        }
+
+        scrollingPosition = 0;
+        scrollingCharWidth = scrollingChar < scrollingText.length() ? columns : width;
 
         if (scrollingChar > scrollingText.length())
         {
@@ -347,6 +541,102 @@ void MicroBitDisplay::updateScrollText()
    }
 }
 
+/**
+  * Renders the given text into the scrolling strip, as it would appear scrolled across the display.
+  *
+  * @param s The text to render.
+  *
+  * @return MICROBIT_OK, or MICROBIT_NO_RESOURCES if the text is longer than MICROBIT_DISPLAY_SCROLL_STRIP_MAX allows.
+  */
+int MicroBitDisplay::renderScrollStrip(ManagedString s)
+{
+    MicroBitGlyph glyph;
+
+    // The text starts just off the right hand edge of the display.
+    int columns = width;
+
+    if (proportionalText)
+    {
+        for (int i = 0; i < s.length(); i++)
+            columns += (MicroBitFont::systemFont.getGlyph(s.charAt(i), &glyph) == MICROBIT_OK ? glyph.width : MICROBIT_FONT_WIDTH) + MICROBIT_DISPLAY_SPACING;
+    }
+    else
+    {
+        columns += s.length() * (MICROBIT_FONT_WIDTH + MICROBIT_DISPLAY_SPACING);
+    }
+
+    scrollingStripLength = 0;
+
+    if (columns > MICROBIT_DISPLAY_SCROLL_STRIP_MAX)
+        return MICROBIT_NO_RESOURCES;
+
+    // Keep the largest strip we've needed, so that repeated messages don't churn the heap.
+    if (columns > scrollingStripCapacity)
+    {
+        delete[] scrollingStrip;
+
+        scrollingStrip = new uint8_t[columns];
+        scrollingStripCapacity = scrollingStrip ? columns : 0;
+
+        if (scrollingStrip == NULL)
+            return MICROBIT_NO_RESOURCES;
+    }
+
+    memset(scrollingStrip, 0, columns);
+
+    // Glyphs are already rasterized into columns, so each one is a straight copy.
+    uint8_t *column = scrollingStrip + width;
+
+    for (int i = 0; i < s.length(); i++)
+    {
+        if (MicroBitFont::systemFont.getGlyph(s.charAt(i), &glyph) != MICROBIT_OK)
+        {
+            column += MICROBIT_FONT_WIDTH + MICROBIT_DISPLAY_SPACING;
+            continue;
+        }
+
+        int first = proportionalText ? glyph.offset : 0;
+        int count = proportionalText ? glyph.width : MICROBIT_FONT_WIDTH;
+
+        // Blank glyphs are given a width, but have no columns to copy.
+        memcpy(column, glyph.columns + first, min(count, MICROBIT_FONT_WIDTH - first));
+        column += count + MICROBIT_DISPLAY_SPACING;
+    }
+
+    scrollingStripLength = columns;
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Internal scrollText update method, used when the text has been pre-rendered.
+  * Copies the next window of the strip onto the display.
+  */
+void MicroBitDisplay::updateScrollStrip()
+{
+    uint8_t *bitmap = image.getMutableBitmap();
+    int stride = image.getWidth();
+    int rows = min(height, MICROBIT_FONT_HEIGHT);
+
+    scrollingStripPosition++;
+
+    for (int x = 0; x < width; x++)
+    {
+        int c = scrollingStripPosition + x;
+        uint8_t column = (c >= 0 && c < scrollingStripLength) ? scrollingStrip[c] : 0;
+
+        for (int y = 0; y < rows; y++)
+            bitmap[y * stride + x] = (column & (1 << y)) ? 255 : 0;
+    }
+
+    // Finish once the trailing spacing has scrolled past, as rendering glyph by glyph does.
+    if (scrollingStripPosition >= scrollingStripLength + MICROBIT_DISPLAY_SPACING)
+    {
+        animationMode = ANIMATION_MODE_NONE;
+        this->sendAnimationCompleteEvent();
+    }
+}
+
 /**
   * Internal printText update method.
   * Paste the next character in the string.
@@ -409,10 +699,12 @@ void MicroBitDisplay::updateAnimateImage()
 
     image.paste(scrollingImage, scrollingImagePosition, 0, 0);
 
+    // Completion may start the next playlist item, so leave its state alone.
     if(scrollingImageStride == 0)
     {
         animationMode = ANIMATION_MODE_NONE;
         this->sendAnimationCompleteEvent();
+        return;
     }
 
     scrollingImageRendered = true;
@@ -425,6 +717,9 @@ void MicroBitDisplay::updateAnimateImage()
   */
 void MicroBitDisplay::stopAnimation()
 {
+    // Discard anything waiting to be displayed.
+    this->playlistClear();
+
     // Reset any ongoing animation.
     if (animationMode != ANIMATION_MODE_NONE)
     {
@@ -434,7 +729,7 @@ void MicroBitDisplay::stopAnimation()
         MicroBitEvent(id,MICROBIT_DISPLAY_EVT_ANIMATION_COMPLETE);
 
         // Wake up aall fibers that may blocked on the animation (if any).
-        MicroBitEvent(MICROBIT_ID_NOTIFY, MICROBIT_DISPLAY_EVT_FREE);
+        MicroBitEvent(MICROBIT_ID_NOTIFY, MICROBIT_DISPLAY_EVT_FREE, CREATE_AND_FIRE_NO_TIMESTAMP);
     }
 
     // Clear the display and setup the animation timers.
@@ -746,9 +1041,15 @@ int MicroBitDisplay::scrollAsync(ManagedString s, int delay)
     if (animationMode == ANIMATION_MODE_NONE || animationMode == ANIMATION_MODE_STOPPED)
     {
         scrollingPosition = width-1;
+        scrollingCharWidth = width;
         scrollingChar = 0;
         scrollingText = s;
 
+        // Pre-render the whole message if we can, so that each step is just a window copy.
+        // The starting position matches the timing of rendering glyph by glyph.
+        if (renderScrollStrip(s) == MICROBIT_OK)
+            scrollingStripPosition = -(MICROBIT_DISPLAY_SPACING + 1);
+
         animationDelay = delay;
         animationTick = 0;
         animationMode = ANIMATION_MODE_SCROLL_TEXT;
@@ -1002,6 +1303,223 @@ int MicroBitDisplay::animate(MicroBitImage image, int delay, int stride, int sta
     return MICROBIT_OK;
 }
 
+/**
+  * Adds an item to the end of the playlist, and starts it if the display is free.
+  *
+  * @return MICROBIT_OK, MICROBIT_INVALID_PARAMETER or MICROBIT_NO_RESOURCES if the playlist is full.
+  */
+int MicroBitDisplay::playlistAdd(uint8_t type, ManagedString text, MicroBitImage image, int delay, int stride)
+{
+    // Items store the stride in a single signed byte.
+    if (delay <= 0 || delay > 0xFFFF || stride < -128 || stride > 127)
+        return MICROBIT_INVALID_PARAMETER;
+
+    if (playlist == NULL)
+    {
+        playlist = new MicroBitDisplayPlaylistItem[MICROBIT_DISPLAY_PLAYLIST_SIZE];
+
+        if (playlist == NULL)
+            return MICROBIT_NO_RESOURCES;
+    }
+
+    if (playlistCount >= MICROBIT_DISPLAY_PLAYLIST_SIZE)
+        return MICROBIT_NO_RESOURCES;
+
+    // The slot after the last waiting item isn't touched by the display, even as items are consumed,
+    // so we can fill it in before publishing it.
+    MicroBitDisplayPlaylistItem &item = playlist[(playlistHead + playlistCount) % MICROBIT_DISPLAY_PLAYLIST_SIZE];
+
+    item.text = text;
+    item.image = image;
+    item.delay = delay;
+    item.stride = stride;
+    item.type = type;
+
+    // Items are started from the display's interrupt handler, which must not have to allocate
+    // a private copy of the displayed bitmap before drawing into it. Take that copy now, if needed.
+    this->image.getMutableBitmap();
+
+    __disable_irq();
+
+    playlistCount++;
+
+    // If the display is free, start straight away. Otherwise, the display will move on to
+    // this item by itself when the animations before it have completed.
+    if (animationMode == ANIMATION_MODE_NONE || animationMode == ANIMATION_MODE_STOPPED)
+        playlistNext();
+
+    __enable_irq();
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Starts the next item in the playlist, if there is one. Must be called with interrupts disabled
+  * or from interrupt context, when no animation is running.
+  *
+  * @return MICROBIT_OK if an item was started, or MICROBIT_NO_DATA if the playlist is empty.
+  */
+int MicroBitDisplay::playlistNext()
+{
+    if (playlistCount == 0)
+        return MICROBIT_NO_DATA;
+
+    MicroBitDisplayPlaylistItem &item = playlist[playlistHead];
+
+    playlistHead = (playlistHead + 1) % MICROBIT_DISPLAY_PLAYLIST_SIZE;
+    playlistCount--;
+
+    switch (item.type)
+    {
+        case PLAYLIST_ITEM_PRINT_IMAGE:
+            printAsync(item.image, 0, 0, 0, item.delay);
+            break;
+
+        case PLAYLIST_ITEM_SCROLL_TEXT:
+            // Text is scrolled glyph by glyph here, as pre-rendering it may need to allocate memory.
+            scrollingPosition = width-1;
+            scrollingCharWidth = width;
+            scrollingChar = 0;
+            scrollingText = item.text;
+            scrollingStripLength = 0;
+
+            animationDelay = item.delay;
+            animationTick = 0;
+            animationMode = ANIMATION_MODE_SCROLL_TEXT;
+            break;
+
+        case PLAYLIST_ITEM_SCROLL_IMAGE:
+            scrollAsync(item.image, item.delay, item.stride);
+            break;
+
+        case PLAYLIST_ITEM_ANIMATE_IMAGE:
+            animateAsync(item.image, item.delay, item.stride);
+            break;
+    }
+
+    // Release the playlist's references to the item's data.
+    item.text = ManagedString::EmptyString;
+    item.image = MicroBitImage();
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Adds an image to the display's playlist, to be shown for the given time.
+  * Items in the playlist are displayed one after another, straight from the display's
+  * periodic update, without waking any fibers between them. MICROBIT_DISPLAY_EVT_ANIMATION_COMPLETE
+  * is raised once the playlist is empty.
+  *
+  * @param i The image to display.
+  *
+  * @param delay The time to display the image for, in milliseconds.
+  *
+  * @return MICROBIT_OK, MICROBIT_INVALID_PARAMETER or MICROBIT_NO_RESOURCES if the playlist is full.
+  *
+  * @code
+  * MicroBitImage heart("0,255,0,255,0\n255,255,255,255,255\n255,255,255,255,255\n0,255,255,255,0\n0,0,255,0,0\n");
+  * display.playlistPrint(heart, 500);
+  * display.playlistScroll("hello");
+  * @endcode
+  */
+int MicroBitDisplay::playlistPrint(MicroBitImage i, int delay)
+{
+    return playlistAdd(PLAYLIST_ITEM_PRINT_IMAGE, ManagedString::EmptyString, i, delay, 0);
+}
+
+/**
+  * Adds text to the display's playlist, to be scrolled from right to left.
+  *
+  * @param s The string to display.
+  *
+  * @param delay The time to delay between characters, in milliseconds. Defaults
+  *              to: MICROBIT_DEFAULT_SCROLL_SPEED.
+  *
+  * @return MICROBIT_OK, MICROBIT_INVALID_PARAMETER or MICROBIT_NO_RESOURCES if the playlist is full.
+  *
+  * @code
+  * display.playlistScroll("abc123",100);
+  * @endcode
+  */
+int MicroBitDisplay::playlistScroll(ManagedString s, int delay)
+{
+    return playlistAdd(PLAYLIST_ITEM_SCROLL_TEXT, s, MicroBitImage(), delay, 0);
+}
+
+/**
+  * Adds an image to the display's playlist, to be scrolled from right to left.
+  *
+  * @param image The image to display.
+  *
+  * @param delay The time between updates, in milliseconds. Defaults
+  *              to: MICROBIT_DEFAULT_SCROLL_SPEED.
+  *
+  * @param stride The number of pixels to shift by in each update. Defaults to MICROBIT_DEFAULT_SCROLL_STRIDE.
+  *
+  * @return MICROBIT_OK, MICROBIT_INVALID_PARAMETER or MICROBIT_NO_RESOURCES if the playlist is full.
+  *
+  * @code
+  * MicrobitImage i("1,1,1,1,1\n1,1,1,1,1\n");
+  * display.playlistScroll(i,100,1);
+  * @endcode
+  */
+int MicroBitDisplay::playlistScroll(MicroBitImage image, int delay, int stride)
+{
+    return playlistAdd(PLAYLIST_ITEM_SCROLL_IMAGE, ManagedString::EmptyString, image, delay, stride);
+}
+
+/**
+  * Adds an image strip to the display's playlist, to be animated with the given stride,
+  * finishing on its last frame.
+  *
+  * @param image The image to display.
+  *
+  * @param delay The time to delay between each update of the display, in milliseconds.
+  *
+  * @param stride The number of pixels to shift by in each update.
+  *
+  * @return MICROBIT_OK, MICROBIT_INVALID_PARAMETER or MICROBIT_NO_RESOURCES if the playlist is full.
+  *
+  * @code
+  * const int heart_w = 10;
+  * const int heart_h = 5;
+  * const uint8_t heart[] = { 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, };
+  *
+  * MicroBitImage i(heart_w,heart_h,heart);
+  * display.playlistAnimate(i,100,5);
+  * @endcode
+  */
+int MicroBitDisplay::playlistAnimate(MicroBitImage image, int delay, int stride)
+{
+    return playlistAdd(PLAYLIST_ITEM_ANIMATE_IMAGE, ManagedString::EmptyString, image, delay, stride);
+}
+
+/**
+  * Removes any items waiting in the display's playlist. The current animation is unaffected.
+  */
+void MicroBitDisplay::playlistClear()
+{
+    if (playlist == NULL)
+        return;
+
+    __disable_irq();
+
+    int head = playlistHead;
+    int count = playlistCount;
+
+    playlistCount = 0;
+
+    __enable_irq();
+
+    for (int i = 0; i < count; i++)
+    {
+        MicroBitDisplayPlaylistItem &item = playlist[(head + i) % MICROBIT_DISPLAY_PLAYLIST_SIZE];
+
+        item.text = ManagedString::EmptyString;
+        item.image = MicroBitImage();
+    }
+}
+
 
 /**
   * Configures the brightness of the display.
@@ -1022,6 +1540,19 @@ int MicroBitDisplay::setBrightness(int b)
 
     this->brightness = b;
 
+    // Precalculate the on time per millisecond of tick period used in black and white modes.
+#if CONFIG_ENABLED(MICROBIT_DISPLAY_GAMMA_CORRECTION)
+    this->brightnessDuty = ((uint32_t)gammaTable[b] * 950) >> 16;
+
+    // As in greyscale mode, keep the dimmest levels visible, rather than rounding them away.
+    if (b && !this->brightnessDuty)
+        this->brightnessDuty = 1;
+#else
+    this->brightnessDuty = (b * 950) / MICROBIT_DISPLAY_MAXIMUM_BRIGHTNESS;
+#endif
+
+    this->frameDirty = true;
+
     return MICROBIT_OK;
 }
 
@@ -1052,6 +1583,36 @@ void MicroBitDisplay::setDisplayMode(DisplayMode mode)
     }
 
     this->mode = mode;
+    this->frameDirty = true;
+}
+
+/**
+  * Selects how scrolling text is laid out.
+  *
+  * In proportional mode each character is only as wide as its glyph, with a narrow gap for spaces,
+  * so messages take fewer frames to scroll. Otherwise every character takes a full font width.
+  * Takes effect from the next call to scroll().
+  *
+  * @param enabled true to lay out text proportionally, false for fixed width characters.
+  *
+  * @code
+  * display.setProportionalText(true);
+  * display.scroll("Hello world!"); // scrolls in fewer frames
+  * @endcode
+  */
+void MicroBitDisplay::setProportionalText(bool enabled)
+{
+    proportionalText = enabled;
+}
+
+/**
+  * Determines if scrolling text is laid out proportionally.
+  *
+  * @return true if proportional layout is in use, false for fixed width characters.
+  */
+bool MicroBitDisplay::isProportionalText()
+{
+    return proportionalText;
 }
 
 /**
@@ -1090,6 +1651,8 @@ int MicroBitDisplay::getBrightness()
 void MicroBitDisplay::rotateTo(DisplayRotation rotation)
 {
     this->rotation = rotation;
+    this->compilePixelMap();
+    this->frameDirty = true;
 }
 
 /**
@@ -1168,6 +1731,113 @@ void MicroBitDisplay::clear()
     image.clear();
 }
 
+/**
+  * Retrieves the back buffer, for applications that wish to draw complete frames without tearing.
+  * The buffer is created on first use, and is the same size as the displayed image. It is created
+  * afresh if the displayed image has since been replaced with one of a different size.
+  *
+  * Draw into the back buffer, then call swap() or swapAsync() to show it. The back buffer
+  * should not be modified again until the swap has completed. A swap exchanges the back buffer
+  * with the displayed image, so afterwards the back buffer holds the frame that was replaced.
+  *
+  * @return a reference to the back buffer. Keep the reference rather than copying it, as writing
+  *         to a copy would give the copy its own bitmap, leaving the back buffer unchanged.
+  *
+  * @code
+  * MicroBitImage &frame = display.getBackBuffer();
+  * frame.setPixelValue(2, 2, 255);
+  * display.swap();
+  * @endcode
+  */
+MicroBitImage& MicroBitDisplay::getBackBuffer()
+{
+    // Until first use, the back buffer is the read-only empty image.
+    if (backBuffer.getWidth() != image.getWidth() || backBuffer.getHeight() != image.getHeight())
+        backBuffer = MicroBitImage(image.getWidth(), image.getHeight());
+
+    return backBuffer;
+}
+
+/**
+  * Requests that the back buffer is shown. The displayed image is updated from the back buffer
+  * at the start of the next refresh, so no frame is ever shown half old and half new.
+  * Returns immediately. MICROBIT_DISPLAY_EVT_FRAME is raised once the new frame has been taken.
+  *
+  * @return MICROBIT_OK, or MICROBIT_NO_DATA if the back buffer has not been created with getBackBuffer(),
+  *         or no longer matches the size of the displayed image.
+  *
+  * @code
+  * display.swapAsync();
+  * fiber_wait_for_event(MICROBIT_ID_DISPLAY, MICROBIT_DISPLAY_EVT_FRAME);
+  * @endcode
+  */
+int MicroBitDisplay::swapAsync()
+{
+    // The frame compiler and the animations rely on the displayed image keeping its size, so never swap in anything else.
+    if (backBuffer.getWidth() != image.getWidth() || backBuffer.getHeight() != image.getHeight())
+        return MICROBIT_NO_DATA;
+
+    // If the display isn't being refreshed, there's no frame boundary to wait for.
+    if (!(status & MICROBIT_COMPONENT_RUNNING))
+    {
+        presentBackBuffer();
+        return MICROBIT_OK;
+    }
+
+    swapPending = true;
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Requests that the back buffer is shown, and blocks the calling fiber until it has been taken
+  * at the start of the next refresh. Calling this in a loop runs an animation in step with the display.
+  *
+  * @return MICROBIT_OK, or MICROBIT_NO_DATA if the back buffer has not been created with getBackBuffer(),
+  *         or no longer matches the size of the displayed image.
+  *
+  * @code
+  * int x = 0;
+  *
+  * while(1)
+  * {
+  *     MicroBitImage &frame = display.getBackBuffer();
+  *     frame.clear();
+  *     frame.setPixelValue(x, 2, 255);
+  *     display.swap();
+  *
+  *     x = (x + 1) % 5;
+  * }
+  * @endcode
+  */
+int MicroBitDisplay::swap()
+{
+    // The frame compiler and the animations rely on the displayed image keeping its size, so never swap in anything else.
+    if (backBuffer.getWidth() != image.getWidth() || backBuffer.getHeight() != image.getHeight())
+        return MICROBIT_NO_DATA;
+
+    // If the display isn't being refreshed, there's no frame boundary to wait for.
+    if (!(status & MICROBIT_COMPONENT_RUNNING))
+    {
+        presentBackBuffer();
+        return MICROBIT_OK;
+    }
+
+    // Register for the frame event before the swap is requested, so it can't be raised
+    // in between and leave us waiting for a frame that has already been taken.
+    int result = fiber_wake_on_event(id, MICROBIT_DISPLAY_EVT_FRAME);
+
+    swapPending = true;
+
+    if (result == MICROBIT_OK)
+        schedule();
+    else
+        while(swapPending)
+            __WFE();
+
+    return MICROBIT_OK;
+}
+
 /**
   * Updates the font that will be used for display operations.
   *
@@ -1233,4 +1903,10 @@ int MicroBitDisplay::readLightLevel()
 MicroBitDisplay::~MicroBitDisplay()
 {
     system_timer_remove_component(this);
+    system_timer_cancel_event(&renderTimer);
+
+    delete[] pixelMap;
+    delete[] frameData;
+    delete[] scrollingStrip;
+    delete[] playlist;
 }
@@ -82,7 +82,7 @@ void MicroBitLightSensor::analogDisable()
   *            Defaults to microbitMatrixMap, defined in MicroBitMatrixMaps.h.
   */
 MicroBitLightSensor::MicroBitLightSensor(const MatrixMap &map) :
-    analogTrigger(),
+    analogTrigger(system_timer_method_call<MicroBitLightSensor, &MicroBitLightSensor::analogReady>, this),
     matrixMap(map)
 {
     this->chan = 0;
@@ -165,7 +165,7 @@ void MicroBitLightSensor::startSensing(MicroBitEvent)
 
     this->sensePin = new AnalogIn(currentPin);
 
-    analogTrigger.attach_us(this, &MicroBitLightSensor::analogReady, MICROBIT_LIGHT_SENSOR_AN_SET_TIME);
+    system_timer_event_after_us(&analogTrigger, MICROBIT_LIGHT_SENSOR_AN_SET_TIME);
 }
 
 /**
@@ -175,6 +175,8 @@ void MicroBitLightSensor::startSensing(MicroBitEvent)
   */
 MicroBitLightSensor::~MicroBitLightSensor()
 {
+    system_timer_cancel_event(&analogTrigger);
+
     if (EventModel::defaultEventBus)
         EventModel::defaultEventBus->ignore(MICROBIT_ID_DISPLAY, MICROBIT_DISPLAY_EVT_LIGHT_SENSE, this, &MicroBitLightSensor::startSensing);
 }
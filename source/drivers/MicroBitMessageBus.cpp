@@ -145,8 +145,10 @@ void async_callback(void *param)
   * Add the given event at the tail of our queue.
   *
   * @param The event to queue.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_NO_RESOURCES if the event was dropped.
   */
-void MicroBitMessageBus::queueEvent(MicroBitEvent &evt)
+int MicroBitMessageBus::queueEvent(MicroBitEvent &evt)
 {
     int processingComplete;
 
@@ -159,11 +161,11 @@ void MicroBitMessageBus::queueEvent(MicroBitEvent &evt)
     // If we've already processed all event handlers, we're all done.
     // No need to queue the event.
     if (processingComplete)
-        return;
+        return MICROBIT_OK;
 
     // If we need to queue, but there is no space, then there's nothg we can do.
     if (queueLength >= MESSAGE_BUS_LISTENER_MAX_QUEUE_DEPTH)
-        return;
+        return MICROBIT_NO_RESOURCES;
 
     // Otherwise, we need to queue this event for later processing...
     // We queue this event at the tail of the queue at the point where we entered queueEvent()
@@ -171,6 +173,9 @@ void MicroBitMessageBus::queueEvent(MicroBitEvent &evt)
     // we want to maintain ordering of events.
     MicroBitEventQueueItem *item = new MicroBitEventQueueItem(evt);
 
+    if (item == NULL)
+        return MICROBIT_NO_RESOURCES;
+
     // The queue was empty when we entered this function, so queue our event at the start of the queue.
     __disable_irq();
 
@@ -191,6 +196,8 @@ void MicroBitMessageBus::queueEvent(MicroBitEvent &evt)
     queueLength++;
 
     __enable_irq();
+
+    return MICROBIT_OK;
 }
 
 /**
@@ -299,6 +306,8 @@ void MicroBitMessageBus::idleTick()
   *
   * @param evt The event to send.
   *
+  * @return MICROBIT_OK on success, or MICROBIT_NO_RESOURCES if the event had to be dropped as the queue is full.
+  *
   * @code
   * MicroBitMessageBus bus;
   *
@@ -319,8 +328,7 @@ int MicroBitMessageBus::send(MicroBitEvent evt)
     // We simply queue processing of the event until we're scheduled in normal thread context.
     // We do this to avoid the possibility of executing event handler code in IRQ context, which may bring
     // hidden race conditions to kids code. Queuing all events ensures causal ordering (total ordering in fact).
-    this->queueEvent(evt);
-    return MICROBIT_OK;
+    return this->queueEvent(evt);
 }
 
 /**
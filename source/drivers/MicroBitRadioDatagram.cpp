@@ -148,6 +148,58 @@ int MicroBitRadioDatagram::send(PacketBuffer data)
     return send((uint8_t *)data.getBytes(), data.length());
 }
 
+/**
+  * Transmits the contents of several buffers onto the broadcast radio as a single packet,
+  * such as a protocol header followed by a payload, without first joining them together.
+  *
+  * This is a synchronous call that will wait until the transmission of the packet
+  * has completed before returning.
+  *
+  * @param buffers The buffers to transmit, in order.
+  *
+  * @param count The number of buffers.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the buffers are invalid,
+  *         or their total length is greater than `MICROBIT_RADIO_MAX_PACKET_SIZE`.
+  *
+  * @code
+  * PacketBuffer parts[] = { header, payload };
+  * uBit.radio.datagram.send(parts, 2);
+  * @endcode
+  */
+int MicroBitRadioDatagram::send(PacketBuffer *buffers, int count)
+{
+    int len = 0;
+
+    if (buffers == NULL || count <= 0)
+        return MICROBIT_INVALID_PARAMETER;
+
+    for (int i = 0; i < count; i++)
+        len += buffers[i].length();
+
+    // Everything is gathered into the frame's payload, so that's all the space there is.
+    if (len > MICROBIT_RADIO_MAX_PACKET_SIZE)
+        return MICROBIT_INVALID_PARAMETER;
+
+    FrameBuffer buf;
+
+    buf.length = len + MICROBIT_RADIO_HEADER_SIZE - 1;
+    buf.version = 1;
+    buf.group = 0;
+    buf.protocol = MICROBIT_RADIO_PROTOCOL_DATAGRAM;
+
+    // Gather each buffer straight into the frame.
+    uint8_t *p = buf.payload;
+
+    for (int i = 0; i < count; i++)
+    {
+        memcpy(p, buffers[i].getBytes(), buffers[i].length());
+        p += buffers[i].length();
+    }
+
+    return radio.send(&buf);
+}
+
 /**
   * Transmits the given string onto the broadcast radio.
   *
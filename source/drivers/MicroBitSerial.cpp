@@ -25,6 +25,7 @@ DEALINGS IN THE SOFTWARE.
 
 #include "mbed.h"
 #include "MicroBitSerial.h"
+#include "ManagedStringBuilder.h"
 #include "ErrorNo.h"
 #include "MicroBitComponent.h"
 #include "MicroBitFiber.h"
@@ -149,7 +150,7 @@ void MicroBitSerial::dataWritten()
     //unblock any waiting fibers that are waiting for transmission to finish.
     if(nextTail == txBuffHead)
     {
-        MicroBitEvent(MICROBIT_ID_NOTIFY, MICROBIT_SERIAL_EVT_TX_EMPTY);
+        MicroBitEvent(MICROBIT_ID_NOTIFY, MICROBIT_SERIAL_EVT_TX_EMPTY, CREATE_AND_FIRE_NO_TIMESTAMP);
         detach(Serial::TxIrq);
     }
 
@@ -513,6 +514,79 @@ int MicroBitSerial::send(uint8_t *buffer, int bufferLen, MicroBitSerialMode mode
     return bytesWritten;
 }
 
+/**
+  * Sends the contents of several buffers over the serial line, one after another,
+  * such as a protocol header followed by a payload, without first joining them together.
+  * No other fiber can send in between them.
+  *
+  * @param buffers the buffers to send, in order.
+  *
+  * @param count the number of buffers.
+  *
+  * @param mode the selected mode, one of: ASYNC, SYNC_SPINWAIT, SYNC_SLEEP, as for send() above.
+  *             In ASYNC mode, sending stops at the first buffer that does not fit in the txBuff.
+  *             Defaults to SYNC_SLEEP.
+  *
+  * @return the total number of bytes written, MICROBIT_SERIAL_IN_USE if another fiber
+  *         is using the serial instance for transmission, or MICROBIT_INVALID_PARAMETER
+  *         if buffers is invalid, or the given count is <= 0.
+  *
+  * @code
+  * PacketBuffer parts[] = { header, payload };
+  * serial.send(parts, 2);
+  * @endcode
+  */
+int MicroBitSerial::send(PacketBuffer *buffers, int count, MicroBitSerialMode mode)
+{
+    if(txInUse())
+        return MICROBIT_SERIAL_IN_USE;
+
+    if(count <= 0 || buffers == NULL)
+        return MICROBIT_INVALID_PARAMETER;
+
+    lockTx();
+
+    //lazy initialisation of our tx buffer
+    if(!(status & MICROBIT_SERIAL_TX_BUFF_INIT))
+    {
+        int result = initialiseTx();
+
+        if(result != MICROBIT_OK)
+        {
+            unlockTx();
+            return result;
+        }
+    }
+
+    int bytesWritten = 0;
+
+    for(int i = 0; i < count; i++)
+    {
+        uint8_t *buffer = buffers[i].getBytes();
+        int bufferLen = buffers[i].length();
+        int written = 0;
+
+        while(written < bufferLen)
+        {
+            written += setTxInterrupt(buffer + written, bufferLen - written, mode);
+            send(mode);
+
+            if(mode == ASYNC)
+                break;
+        }
+
+        bytesWritten += written;
+
+        //in ASYNC mode, don't send later buffers if this one didn't fit.
+        if(written < bufferLen)
+            break;
+    }
+
+    unlockTx();
+
+    return bytesWritten;
+}
+
 /**
   * Reads a single character from the rxBuff
   *
@@ -680,6 +754,72 @@ int MicroBitSerial::read(uint8_t *buffer, int bufferLen, MicroBitSerialMode mode
 }
 
 
+/**
+  * An internal method that finds the first delimeter in the rxBuff, waiting for one as
+  * dictated by the given mode. The caller must hold the rx lock.
+  *
+  * @param delimeters a ManagedString containing a sequence of delimeter characters
+  *
+  * @param mode the selected mode, as for readUntil().
+  *
+  * @return the number of characters that precede the delimeter, or -1 if none was found.
+  */
+int MicroBitSerial::scanUntil(ManagedString delimeters, MicroBitSerialMode mode)
+{
+    int localTail = rxBuffTail;
+    int preservedTail = rxBuffTail;
+
+    int foundIndex = -1;
+
+    //ASYNC mode just iterates through our stored characters checking for any matches.
+    while(localTail != rxBuffHead && foundIndex  == -1)
+    {
+        //we use localTail to prevent modification of the actual tail.
+        char c = rxBuff[localTail];
+
+        for(int delimeterIterator = 0; delimeterIterator < delimeters.length(); delimeterIterator++)
+            if(delimeters.charAt(delimeterIterator) == c)
+                foundIndex = localTail;
+
+        localTail = (localTail + 1) % rxBuffSize;
+    }
+
+    //if our mode is SYNC_SPINWAIT and we didn't see any matching characters in our buffer
+    //spin until we find a match!
+    if(mode == SYNC_SPINWAIT)
+    {
+        while(foundIndex == -1)
+        {
+            while(localTail == rxBuffHead);
+
+            char c = rxBuff[localTail];
+
+            for(int delimeterIterator = 0; delimeterIterator < delimeters.length(); delimeterIterator++)
+                if(delimeters.charAt(delimeterIterator) == c)
+                    foundIndex = localTail;
+
+            localTail = (localTail + 1) % rxBuffSize;
+        }
+    }
+
+    //if our mode is SYNC_SLEEP, we set up an event to be fired when we see a
+    //matching character.
+    if(mode == SYNC_SLEEP && foundIndex == -1)
+    {
+        eventOn(delimeters, mode);
+
+        foundIndex = rxBuffHead - 1;
+
+        this->delimeters = ManagedString();
+    }
+
+    if(foundIndex < 0)
+        return -1;
+
+    //calculate the number of characters before the delimeter
+    return (preservedTail > foundIndex) ? (rxBuffSize - preservedTail) + foundIndex : foundIndex - preservedTail;
+}
+
 /**
   * Reads until one of the delimeters matches a character in the rxBuff
   *
@@ -726,75 +866,92 @@ ManagedString MicroBitSerial::readUntil(ManagedString delimeters, MicroBitSerial
 
     lockRx();
 
-    int localTail = rxBuffTail;
-    int preservedTail = rxBuffTail;
+    int localBuffSize = scanUntil(delimeters, mode);
 
-    int foundIndex = -1;
-
-    //ASYNC mode just iterates through our stored characters checking for any matches.
-    while(localTail != rxBuffHead && foundIndex  == -1)
+    if(localBuffSize >= 0)
     {
-        //we use localTail to prevent modification of the actual tail.
-        char c = rxBuff[localTail];
+        //copy straight out of the circular buffer, in at most two runs, into an exactly sized string.
+        int firstRun = min(localBuffSize, rxBuffSize - rxBuffTail);
 
-        for(int delimeterIterator = 0; delimeterIterator < delimeters.length(); delimeterIterator++)
-            if(delimeters.charAt(delimeterIterator) == c)
-                foundIndex = localTail;
+        ManagedStringBuilder builder(localBuffSize);
+        builder.append((char *)rxBuff + rxBuffTail, firstRun);
+        builder.append((char *)rxBuff, localBuffSize - firstRun);
 
-        localTail = (localTail + 1) % rxBuffSize;
+        //plus one for the character we listened for...
+        rxBuffTail = (rxBuffTail + localBuffSize + 1) % rxBuffSize;
+
+        unlockRx();
+
+        return builder.toManagedString();
     }
 
-    //if our mode is SYNC_SPINWAIT and we didn't see any matching characters in our buffer
-    //spin until we find a match!
-    if(mode == SYNC_SPINWAIT)
-    {
-        while(foundIndex == -1)
-        {
-            while(localTail == rxBuffHead);
+    unlockRx();
 
-            char c = rxBuff[localTail];
+    return ManagedString();
+}
 
-            for(int delimeterIterator = 0; delimeterIterator < delimeters.length(); delimeterIterator++)
-                if(delimeters.charAt(delimeterIterator) == c)
-                    foundIndex = localTail;
+/**
+  * Reads characters until a character matches one of the given delimeters, into a buffer
+  * supplied by the caller. No memory is allocated, so this pairs well with StringView for
+  * parsing received commands.
+  *
+  * Characters beyond the end of the buffer are discarded, up to and including the delimeter.
+  *
+  * @param buffer a pointer to a memory location where the characters should be placed.
+  *
+  * @param bufferLen the size of the buffer.
+  *
+  * @param delimeters a ManagedString containing a sequence of delimeter characters e.g. ManagedString("\r\n")
+  *
+  * @param mode the selected mode, one of: ASYNC, SYNC_SPINWAIT, SYNC_SLEEP, as for readUntil() above.
+  *             Defaults to SYNC_SLEEP.
+  *
+  * @return the number of characters placed in the buffer, which may be 0 if no delimeter was found,
+  *         or MICROBIT_SERIAL_IN_USE if another fiber is currently using this instance for reception.
+  *
+  * @code
+  * char line[32];
+  * int n = serial.readUntil((uint8_t *)line, sizeof(line), "\n");
+  * StringView command(line, n);
+  * @endcode
+  *
+  * @note delimeters are matched on a per byte basis.
+  */
+int MicroBitSerial::readUntil(uint8_t *buffer, int bufferLen, ManagedString delimeters, MicroBitSerialMode mode)
+{
+    if(rxInUse())
+        return MICROBIT_SERIAL_IN_USE;
 
-            localTail = (localTail + 1) % rxBuffSize;
-        }
-    }
+    if(buffer == NULL || bufferLen <= 0)
+        return MICROBIT_INVALID_PARAMETER;
 
-    //if our mode is SYNC_SLEEP, we set up an event to be fired when we see a
-    //matching character.
-    if(mode == SYNC_SLEEP && foundIndex == -1)
+    //lazy initialisation of our rx buffer
+    if(!(status & MICROBIT_SERIAL_RX_BUFF_INIT))
     {
-        eventOn(delimeters, mode);
-
-        foundIndex = rxBuffHead - 1;
+        int result = initialiseRx();
 
-        this->delimeters = ManagedString();
+        if(result != MICROBIT_OK)
+            return result;
     }
 
-    if(foundIndex >= 0)
-    {
-        //calculate our local buffer size
-        int localBuffSize = (preservedTail > foundIndex) ? (rxBuffSize - preservedTail) + foundIndex : foundIndex - preservedTail;
+    lockRx();
 
-        uint8_t localBuff[localBuffSize + 1];
+    int localBuffSize = scanUntil(delimeters, mode);
+    int copied = 0;
 
-        memclr(&localBuff, localBuffSize + 1);
+    if(localBuffSize >= 0)
+    {
+        copied = min(localBuffSize, bufferLen);
 
-        circularCopy(rxBuff, rxBuffSize, localBuff, preservedTail, foundIndex);
+        circularCopy(rxBuff, rxBuffSize, buffer, rxBuffTail, (rxBuffTail + copied) % rxBuffSize);
 
         //plus one for the character we listened for...
         rxBuffTail = (rxBuffTail + localBuffSize + 1) % rxBuffSize;
-
-        unlockRx();
-
-        return ManagedString((char *)localBuff, localBuffSize);
     }
 
     unlockRx();
 
-    return ManagedString();
+    return copied;
 }
 
 /**
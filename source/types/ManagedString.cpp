@@ -49,9 +49,22 @@ DEALINGS IN THE SOFTWARE.
 #include "MicroBitConfig.h"
 #include "ManagedString.h"
 #include "MicroBitCompat.h"
+#include "MicroBitPool.h"
 
 static const char empty[] __attribute__ ((aligned (4))) = "\xff\xff\0\0\0";
 
+#if MICROBIT_STRING_INLINE_SIZE < 4 || MICROBIT_STRING_INLINE_SIZE > 128
+#error "MICROBIT_STRING_INLINE_SIZE must be between 4 and 128"
+#endif
+
+/**
+  * The intern table. Each entry holds a reference to its StringData, which keeps it
+  * in memory for the life of the program, together with the hash of its characters.
+  */
+static StringData *internTable[MICROBIT_STRING_INTERN_TABLE_SIZE];
+static uint16_t internHash[MICROBIT_STRING_INTERN_TABLE_SIZE];
+static int internCount = 0;
+
 /**
   * Internal constructor helper.
   *
@@ -72,10 +85,55 @@ void ManagedString::initString(const char *str)
     // Initialise this ManagedString as a new string, using the data provided.
     // We assume the string is sane, and null terminated.
     int len = strlen(str);
-    ptr = (StringData *) malloc(4+len+1);
+    memcpy(initBuffer(len), str, len);
+}
+
+/**
+  * Internal constructor helper.
+  *
+  * Sets up storage for a string of the given length, inline if it is short enough and
+  * in a new StringData otherwise, and NULL terminates it. Any current contents are
+  * discarded without being released.
+  *
+  * @param len The length of the string, which must be greater than zero.
+  *
+  * @return a pointer to where the characters of the string should be written.
+  */
+char *ManagedString::initBuffer(int len)
+{
+    if (len <= MANAGED_STRING_INLINE_LENGTH)
+    {
+        inlineData[0] = (len << 1) | 1;
+        inlineData[len + 1] = 0;
+        return inlineData + 1;
+    }
+
+    ptr = (StringData *) microbit_pool_alloc(4+len+1);
     ptr->init();
     ptr->len = len;
-    memcpy(ptr->data, str, len+1);
+    ptr->data[len] = 0;
+    return ptr->data;
+}
+
+/**
+  * Provides a StringData holding the characters of this string, with a new reference for the caller.
+  * This is our own StringData, or a copy of the characters if we are held inline.
+  */
+StringData *ManagedString::toStringData() const
+{
+    if (!isInline())
+    {
+        ptr->incr();
+        return ptr;
+    }
+
+    int len = length();
+    StringData *p = (StringData *) microbit_pool_alloc(4+len+1);
+    p->init();
+    p->len = len;
+    memcpy(p->data, toCharArray(), len+1);
+
+    return p;
 }
 
 /**
@@ -108,7 +166,7 @@ ManagedString::ManagedString(StringData *p)
   */
 StringData* ManagedString::leakData()
 {
-    StringData *res = ptr;
+    StringData *res = isInline() ? toStringData() : ptr;
     initEmpty();
     return res;
 }
@@ -192,14 +250,11 @@ ManagedString::ManagedString(const ManagedString &s1, const ManagedString &s2)
     int len = s1.length() + s2.length();
 
     // Create a new buffer for holding the new string data.
-    ptr = (StringData*) malloc(4+len+1);
-    ptr->init();
-    ptr->len = len;
+    char *data = initBuffer(len);
 
-    // Enter the data, and terminate the string.
-    memcpy(ptr->data, s1.toCharArray(), s1.length());
-    memcpy(ptr->data + s1.length(), s2.toCharArray(), s2.length());
-    ptr->data[len] = 0;
+    // Enter the data. initBuffer() has already terminated the string.
+    memcpy(data, s1.toCharArray(), s1.length());
+    memcpy(data + s1.length(), s2.toCharArray(), s2.length());
 }
 
 
@@ -222,13 +277,7 @@ ManagedString::ManagedString(PacketBuffer buffer)
     }
 
     // Allocate a new buffer ( just in case the data is not NULL terminated).
-    ptr = (StringData*) malloc(4+buffer.length()+1);
-    ptr->init();
-
-    // Store the length of the new string
-    ptr->len = buffer.length();
-    memcpy(ptr->data, buffer.getBytes(), buffer.length());
-    ptr->data[buffer.length()] = 0;
+    memcpy(initBuffer(buffer.length()), buffer.getBytes(), buffer.length());
 }
 
 /**
@@ -257,12 +306,7 @@ ManagedString::ManagedString(const char *str, const int16_t length)
 
 
     // Allocate a new buffer, and create a NULL terminated string.
-    ptr = (StringData*) malloc(4+length+1);
-    ptr->init();
-    // Store the length of the new string
-    ptr->len = length;
-    memcpy(ptr->data, str, length);
-    ptr->data[length] = 0;
+    memcpy(initBuffer(length), str, length);
 }
 
 /**
@@ -280,8 +324,11 @@ ManagedString::ManagedString(const char *str, const int16_t length)
   */
 ManagedString::ManagedString(const ManagedString &s)
 {
-    ptr = s.ptr;
-    ptr->incr();
+    // Copying the whole union takes either the pointer or the inline characters, whichever is in use.
+    memcpy(inlineData, s.inlineData, sizeof(inlineData));
+
+    if (!isInline())
+        ptr->incr();
 }
 
 
@@ -309,7 +356,8 @@ ManagedString::ManagedString()
   */
 ManagedString::~ManagedString()
 {
-    ptr->decr();
+    if (!isInline())
+        ptr->decr();
 }
 
 /**
@@ -333,16 +381,57 @@ ManagedString::~ManagedString()
   */
 ManagedString& ManagedString::operator = (const ManagedString& s)
 {
-    if (this->ptr == s.ptr)
+    if (this == &s)
         return *this;
 
-    ptr->decr();
-    ptr = s.ptr;
-    ptr->incr();
+    // Take the new reference first, in case both strings share the same StringData.
+    if (!s.isInline())
+        s.ptr->incr();
+
+    if (!isInline())
+        ptr->decr();
+
+    memcpy(inlineData, s.inlineData, sizeof(inlineData));
 
     return *this;
 }
 
+#if CONFIG_ENABLED(MICROBIT_MOVE_SEMANTICS)
+/**
+  * Move constructor.
+  * Takes over the data of a ManagedString that is about to be destroyed, without
+  * changing its reference count.
+  *
+  * @param s The ManagedString to move from. It is left as the empty string.
+  */
+ManagedString::ManagedString(ManagedString &&s)
+{
+    memcpy(inlineData, s.inlineData, sizeof(inlineData));
+    s.initEmpty();
+}
+
+/**
+  * Move assign operation.
+  * Releases our current data, and takes over that of a ManagedString that is about to
+  * be destroyed, without changing its reference count.
+  *
+  * @param s The ManagedString to move from. It is left as the empty string.
+  */
+ManagedString& ManagedString::operator = (ManagedString &&s)
+{
+    if(this == &s)
+        return *this;
+
+    if (!isInline())
+        ptr->decr();
+
+    memcpy(inlineData, s.inlineData, sizeof(inlineData));
+    s.initEmpty();
+
+    return *this;
+}
+#endif
+
 /**
   * Equality operation.
   *
@@ -365,7 +454,12 @@ ManagedString& ManagedString::operator = (const ManagedString& s)
   */
 bool ManagedString::operator== (const ManagedString& s)
 {
-    return ((length() == s.length()) && (strcmp(toCharArray(),s.toCharArray())==0));
+    // Copies of the same string, and interned strings, share their data.
+    // Inline strings overlap ptr with their characters, so must always be compared in full.
+    if (ptr == s.ptr && !isInline())
+        return true;
+
+    return ((length() == s.length()) && (memcmp(toCharArray(),s.toCharArray(),length())==0));
 }
 
 /**
@@ -390,6 +484,9 @@ bool ManagedString::operator== (const ManagedString& s)
   */
 bool ManagedString::operator< (const ManagedString& s)
 {
+    if (ptr == s.ptr && !isInline())
+        return false;
+
     return (strcmp(toCharArray(), s.toCharArray())<0);
 }
 
@@ -415,6 +512,9 @@ bool ManagedString::operator< (const ManagedString& s)
   */
 bool ManagedString::operator> (const ManagedString& s)
 {
+    if (ptr == s.ptr && !isInline())
+        return false;
+
     return (strcmp(toCharArray(), s.toCharArray())>0);
 }
 
@@ -493,7 +593,76 @@ ManagedString operator+ (const ManagedString& lhs, const ManagedString& rhs)
   */
 char ManagedString::charAt(int16_t index)
 {
-    return (index >=0 && index < length()) ? ptr->data[index] : 0;
+    return (index >=0 && index < length()) ? toCharArray()[index] : 0;
+}
+
+/**
+  * Computes a 16 bit hash of the characters of this ManagedString.
+  *
+  * @return the hash of the string. Equal strings always have equal hashes.
+  */
+uint16_t ManagedString::hash() const
+{
+    // 32 bit FNV-1a, folded down to 16 bits.
+    uint32_t h = 2166136261UL;
+    const char *data = toCharArray();
+
+    for (int i = 0; i < length(); i++)
+    {
+        h ^= (uint8_t)data[i];
+        h *= 16777619UL;
+    }
+
+    return (h >> 16) ^ (h & 0xffff);
+}
+
+/**
+  * Returns the canonical instance of this string from the intern table, adding this
+  * one if it is not already there.
+  *
+  * Interned strings with the same characters share a single StringData, so comparing
+  * them for equality is a pointer comparison, and repeated copies cost no memory.
+  * Strings added to the table stay in memory for the life of the program, so intern
+  * only long lived strings such as keys, names and delimiter sets.
+  *
+  * Strings of up to MANAGED_STRING_INLINE_LENGTH characters are held inline rather than in a
+  * StringData, so they are returned unchanged and are never added to the table. They already
+  * cost no heap, and are always compared by value.
+  *
+  * @return the canonical instance of this string, or this string itself if it is held inline
+  *         or the table is full.
+  */
+ManagedString ManagedString::intern() const
+{
+    // Inline strings already cost no heap, and share nothing to compare by pointer.
+    if (isInline())
+        return *this;
+
+    uint16_t h = hash();
+
+    // Only compare the characters of entries whose hash and length already match.
+    for (int i = 0; i < internCount; i++)
+    {
+        StringData *p = internTable[i];
+
+        if (p == ptr)
+            return *this;
+
+        if (internHash[i] == h && p->len == ptr->len && memcmp(p->data, ptr->data, ptr->len) == 0)
+            return ManagedString(p);
+    }
+
+    if (internCount == MICROBIT_STRING_INTERN_TABLE_SIZE)
+        return *this;
+
+    // Pin the string with a reference of our own. Strings in flash need no pinning, and incr() ignores them.
+    ptr->incr();
+
+    internTable[internCount] = ptr;
+    internHash[internCount] = h;
+    internCount++;
+
+    return *this;
 }
 
 /**
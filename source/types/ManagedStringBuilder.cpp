@@ -0,0 +1,286 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 British Broadcasting Corporation.
+This software is provided by Lancaster University by arrangement with the BBC.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+  * Class definition for a ManagedStringBuilder.
+  *
+  * Builds up a ManagedString from many pieces using a single growable buffer.
+  */
+
+#include "MicroBitConfig.h"
+#include "ManagedStringBuilder.h"
+#include "MicroBitCompat.h"
+#include "MicroBitPool.h"
+#include "ErrorNo.h"
+
+// The longest string a StringData can describe.
+#define MANAGED_STRING_BUILDER_MAX_LENGTH   0xfffe
+
+/**
+  * Constructor.
+  * Creates an empty builder. No memory is allocated until the first append.
+  *
+  * @param capacity The number of characters to allocate room for initially. Defaults to MANAGED_STRING_BUILDER_DEFAULT_CAPACITY.
+  */
+ManagedStringBuilder::ManagedStringBuilder(int capacity)
+{
+    this->buffer = NULL;
+    this->capacity = min(max(capacity, 1), MANAGED_STRING_BUILDER_MAX_LENGTH);
+}
+
+/**
+  * Destructor.
+  *
+  * Frees the buffer, if it has not been handed to a ManagedString.
+  */
+ManagedStringBuilder::~ManagedStringBuilder()
+{
+    if (buffer)
+        microbit_pool_free(buffer);
+}
+
+/**
+  * Ensures the buffer has room for at least the given number of further characters.
+  *
+  * @return MICROBIT_OK, or MICROBIT_NO_RESOURCES if the string would exceed its maximum length.
+  */
+int ManagedStringBuilder::grow(int n)
+{
+    int needed = length() + n;
+
+    if (buffer && needed <= capacity)
+        return MICROBIT_OK;
+
+    if (needed > MANAGED_STRING_BUILDER_MAX_LENGTH)
+        return MICROBIT_NO_RESOURCES;
+
+    // Grow by half again each time, so the total copying stays linear in the final length.
+    int newCapacity = capacity;
+
+    if (buffer)
+        newCapacity += capacity >> 1;
+
+    newCapacity = min(max(newCapacity, needed), MANAGED_STRING_BUILDER_MAX_LENGTH);
+
+    StringData *b = (StringData *) microbit_pool_alloc(4 + newCapacity + 1);
+
+    if (b == NULL)
+        return MICROBIT_NO_RESOURCES;
+
+    b->len = length();
+
+    if (buffer)
+    {
+        memcpy(b->data, buffer->data, buffer->len);
+        microbit_pool_free(buffer);
+    }
+
+    buffer = b;
+    capacity = newCapacity;
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Ensures the builder can hold at least the given number of characters without reallocating.
+  *
+  * @param capacity The number of characters to reserve room for.
+  *
+  * @return MICROBIT_OK, or MICROBIT_NO_RESOURCES if the capacity cannot be provided.
+  */
+int ManagedStringBuilder::reserve(int capacity)
+{
+    if (capacity > MANAGED_STRING_BUILDER_MAX_LENGTH)
+        return MICROBIT_NO_RESOURCES;
+
+    if (buffer == NULL)
+    {
+        this->capacity = max(this->capacity, capacity);
+        return MICROBIT_OK;
+    }
+
+    return grow(capacity - length());
+}
+
+/**
+  * Appends the given number of characters from a buffer.
+  *
+  * @param s The characters to append.
+  *
+  * @param length The number of characters to append.
+  *
+  * @return A reference to this builder, so appends can be chained.
+  */
+ManagedStringBuilder& ManagedStringBuilder::append(const char *s, int length)
+{
+    if (s == NULL || length <= 0 || grow(length) != MICROBIT_OK)
+        return *this;
+
+    memcpy(buffer->data + buffer->len, s, length);
+    buffer->len += length;
+
+    return *this;
+}
+
+/**
+  * Appends a ManagedString.
+  *
+  * @param s The string to append.
+  *
+  * @return A reference to this builder, so appends can be chained.
+  */
+ManagedStringBuilder& ManagedStringBuilder::append(const ManagedString &s)
+{
+    return append(s.toCharArray(), s.length());
+}
+
+/**
+  * Appends a NULL terminated character array.
+  *
+  * @param s The characters to append.
+  *
+  * @return A reference to this builder, so appends can be chained.
+  */
+ManagedStringBuilder& ManagedStringBuilder::append(const char *s)
+{
+    if (s == NULL)
+        return *this;
+
+    return append(s, strlen(s));
+}
+
+/**
+  * Appends a single character.
+  *
+  * @param c The character to append.
+  *
+  * @return A reference to this builder, so appends can be chained.
+  */
+ManagedStringBuilder& ManagedStringBuilder::append(char c)
+{
+    if (grow(1) == MICROBIT_OK)
+        buffer->data[buffer->len++] = c;
+
+    return *this;
+}
+
+/**
+  * Appends the decimal representation of an integer.
+  *
+  * @param value The integer to append.
+  *
+  * @return A reference to this builder, so appends can be chained.
+  */
+ManagedStringBuilder& ManagedStringBuilder::append(int value)
+{
+    return appendFixed(value, 0);
+}
+
+/**
+  * Appends the decimal representation of a fixed point number.
+  *
+  * @param value The number to append, scaled up by 10 to the power of places.
+  *
+  * @param places The number of digits after the decimal point, from 0 to 9.
+  *
+  * @return A reference to this builder, so appends can be chained.
+  *
+  * @code
+  * b.append("temp=").appendFixed(tenths, 1);
+  * @endcode
+  */
+ManagedStringBuilder& ManagedStringBuilder::appendFixed(int value, int places)
+{
+    // Format straight into our buffer, which always has room for a terminator.
+    if (grow(12) == MICROBIT_OK)
+    {
+        int len = fixed_itoa(value, places, buffer->data + buffer->len);
+
+        if (len > 0)
+            buffer->len += len;
+    }
+
+    return *this;
+}
+
+/**
+  * Appends the contents of a PacketBuffer.
+  *
+  * @param buffer The bytes to append.
+  *
+  * @return A reference to this builder, so appends can be chained.
+  */
+ManagedStringBuilder& ManagedStringBuilder::append(PacketBuffer buffer)
+{
+    return append((const char *)buffer.getBytes(), buffer.length());
+}
+
+/**
+  * Discards everything appended so far, keeping the buffer for reuse.
+  */
+void ManagedStringBuilder::clear()
+{
+    if (buffer)
+        buffer->len = 0;
+}
+
+/**
+  * Finishes the string, and returns it as a ManagedString. The builder is left empty.
+  *
+  * If the buffer is reasonably full it becomes the payload of the ManagedString directly,
+  * and the builder allocates a fresh one on its next append. Otherwise the contents are
+  * copied into an exactly sized string, and the buffer is kept for reuse.
+  *
+  * @return The string that has been built.
+  */
+ManagedString ManagedStringBuilder::toManagedString()
+{
+    if (length() == 0)
+        return ManagedString::EmptyString;
+
+    // Copy out of buffers that are more than a quarter empty, rather than pin the slack to a long lived string.
+    // Short strings are copied into the ManagedString itself.
+    if (buffer->len <= MANAGED_STRING_INLINE_LENGTH || buffer->len < capacity - (capacity >> 2))
+    {
+        ManagedString s;
+        memcpy(s.initBuffer(buffer->len), buffer->data, buffer->len);
+
+        clear();
+
+        return s;
+    }
+
+    StringData *p = buffer;
+    buffer = NULL;
+
+    p->data[p->len] = 0;
+    p->init();
+
+    // The ManagedString takes its own reference, so release ours.
+    ManagedString s(p);
+    p->decr();
+
+    return s;
+}
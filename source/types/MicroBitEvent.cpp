@@ -45,6 +45,8 @@ EventModel* EventModel::defaultEventBus = NULL;
   * @param mode Optional definition of how the event should be processed after construction (if at all):
   *                 CREATE_ONLY: MicroBitEvent is initialised, and no further processing takes place.
   *                 CREATE_AND_FIRE: MicroBitEvent is initialised, and its event handlers are immediately fired (not suitable for use in interrupts!).
+  *                 CREATE_ONLY_NO_TIMESTAMP, CREATE_AND_FIRE_NO_TIMESTAMP: As above, but the timestamp is left as zero.
+  *                 This saves reading the system clock for events whose listeners never inspect it.
   *
   * @code
   * // Create and launch an event using the default configuration
@@ -58,9 +60,13 @@ MicroBitEvent::MicroBitEvent(uint16_t source, uint16_t value, MicroBitEventLaunc
 {
     this->source = source;
     this->value = value;
-    this->timestamp = system_timer_current_time_us();
 
-    if(mode != CREATE_ONLY)
+    if(mode == CREATE_ONLY_NO_TIMESTAMP || mode == CREATE_AND_FIRE_NO_TIMESTAMP)
+        this->timestamp = 0;
+    else
+        this->timestamp = system_timer_current_time_us();
+
+    if(mode == CREATE_AND_FIRE || mode == CREATE_AND_FIRE_NO_TIMESTAMP)
         this->fire();
 }
 
@@ -32,8 +32,10 @@ DEALINGS IN THE SOFTWARE.
 
 #include "MicroBitConfig.h"
 #include "MicroBitImage.h"
+#include "MicroBitMonoImage.h"
 #include "MicroBitFont.h"
 #include "MicroBitCompat.h"
+#include "MicroBitPool.h"
 #include "ManagedString.h"
 #include "ErrorNo.h"
 
@@ -43,6 +45,43 @@ DEALINGS IN THE SOFTWARE.
   */
 static const uint16_t empty[] __attribute__ ((aligned (4))) = { 0xffff, 1, 1, 0, };
 MicroBitImage MicroBitImage::EmptyImage((ImageData*)(void*)empty);
+volatile uint32_t MicroBitImage::writeCount = 0;
+
+/**
+  * Reads four consecutive pixels as a little endian word.
+  * The bitmap has no word alignment, so unaligned pixels are gathered a byte at a time.
+  */
+static inline uint32_t image_read_word(const uint8_t *p)
+{
+    if (((uint32_t)p & 3) == 0)
+        return *(const uint32_t *)p;
+
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+  * Returns a word with 0x01 in each byte of v that is non zero, and 0x00 elsewhere.
+  */
+static inline uint32_t image_nonzero_bytes(uint32_t v)
+{
+    return ((((v & 0x7f7f7f7f) + 0x7f7f7f7f) | v) >> 7) & 0x01010101;
+}
+
+/**
+  * Fills the given columns of every row with zero.
+  */
+static void image_clear_columns(uint8_t *p, int width, int height, int x, int n)
+{
+    p += x;
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int i = 0; i < n; i++)
+            p[i] = 0;
+
+        p += width;
+    }
+}
 
 /**
   * Default Constructor.
@@ -86,12 +125,13 @@ MicroBitImage::MicroBitImage(const int16_t x, const int16_t y)
 /**
   * Copy Constructor.
   * Add ourselves as a reference to an existing MicroBitImage.
+  * The bitmap is shared, with no copying, until either image is modified.
   *
   * @param image The MicroBitImage to reference.
   *
   * @code
   * MicroBitImage i("0,1,0,1,0\n");
-  * MicroBitImage i2(i); //points to i
+  * MicroBitImage i2(i); //points to i, until one of them is changed
   * @endcode
   */
 MicroBitImage::MicroBitImage(const MicroBitImage &image)
@@ -168,7 +208,7 @@ MicroBitImage::MicroBitImage(const char *s)
     // Second pass: collect the data.
     parseReadPtr = s;
     parseValue = -1;
-    bitmapPtr = this->getBitmap();
+    bitmapPtr = this->getMutableBitmap();
 
     while (*parseReadPtr)
     {
@@ -268,6 +308,34 @@ void MicroBitImage::init_empty()
     ptr = (ImageData*)(void*)empty;
 }
 
+/**
+  * Ensures this instance holds the only reference to its bitmap, so it can be written
+  * without affecting any other MicroBitImage.
+  *
+  * Bitmaps that are shared, or that reside in flash, are copied into RAM and this
+  * instance is moved onto the copy. A bitmap we already own outright is left alone.
+  */
+void MicroBitImage::unshare()
+{
+    // A count of 3 is a single outstanding reference (see RefCounted::init).
+    if (ptr->refCount == 3)
+        return;
+
+    ImageData *copy = (ImageData*)microbit_pool_alloc(sizeof(ImageData) + getSize());
+
+    // Writing on regardless would corrupt every other user of the shared bitmap, or fault on flash.
+    if (copy == NULL)
+        microbit_panic(MICROBIT_OOM);
+
+    copy->init();
+    copy->width = ptr->width;
+    copy->height = ptr->height;
+    memcpy(copy->data, ptr->data, getSize());
+
+    ptr->decr();
+    ptr = copy;
+}
+
 /**
   * Internal constructor which provides sanity checking and initialises class properties.
   *
@@ -288,7 +356,7 @@ void MicroBitImage::init(const int16_t x, const int16_t y, const uint8_t *bitmap
 
 
     // Create a copy of the array
-    ptr = (ImageData*)malloc(sizeof(ImageData) + x * y);
+    ptr = (ImageData*)microbit_pool_alloc(sizeof(ImageData) + x * y);
     ptr->init();
     ptr->width = x;
     ptr->height = y;
@@ -333,6 +401,40 @@ MicroBitImage& MicroBitImage::operator = (const MicroBitImage& i)
     return *this;
 }
 
+#if CONFIG_ENABLED(MICROBIT_MOVE_SEMANTICS)
+/**
+  * Move constructor.
+  * Takes over the data of a MicroBitImage that is about to be destroyed, without
+  * changing its reference count.
+  *
+  * @param i The MicroBitImage to move from. It is left as the empty image.
+  */
+MicroBitImage::MicroBitImage(MicroBitImage &&i)
+{
+    ptr = i.ptr;
+    i.init_empty();
+}
+
+/**
+  * Move assign operation.
+  * Releases our current data, and takes over that of a MicroBitImage that is about to
+  * be destroyed, without changing its reference count.
+  *
+  * @param i The MicroBitImage to move from. It is left as the empty image.
+  */
+MicroBitImage& MicroBitImage::operator = (MicroBitImage &&i)
+{
+    if(this == &i)
+        return *this;
+
+    ptr->decr();
+    ptr = i.ptr;
+    i.init_empty();
+
+    return *this;
+}
+#endif
+
 /**
   * Equality operation.
   *
@@ -370,7 +472,7 @@ bool MicroBitImage::operator== (const MicroBitImage& i)
   */
 void MicroBitImage::clear()
 {
-    memclr(getBitmap(), getSize());
+    memclr(getMutableBitmap(), getSize());
 }
 
 /**
@@ -397,7 +499,7 @@ int MicroBitImage::setPixelValue(int16_t x , int16_t y, uint8_t value)
     if(x >= getWidth() || y >= getHeight() || x < 0 || y < 0)
         return MICROBIT_INVALID_PARAMETER;
 
-    this->getBitmap()[y*getWidth()+x] = value;
+    this->getMutableBitmap()[y*getWidth()+x] = value;
     return MICROBIT_OK;
 }
 
@@ -459,7 +561,7 @@ int MicroBitImage::printImage(int16_t width, int16_t height, const uint8_t *bitm
     pixelsToCopyY = min(height,this->getHeight());
 
     pIn = bitmap;
-    pOut = this->getBitmap();
+    pOut = this->getMutableBitmap();
 
     // Copy the image, stride by stride.
     for (int i=0; i<pixelsToCopyY; i++)
@@ -513,7 +615,7 @@ int MicroBitImage::paste(const MicroBitImage &image, int16_t x, int16_t y, uint8
     pIn += (x < 0) ? -x : 0;
     pIn += (y < 0) ? -image.getWidth()*y : 0;
 
-    pOut = getBitmap();
+    pOut = getMutableBitmap();
     pOut += (x > 0) ? x : 0;
     pOut += (y > 0) ? getWidth()*y : 0;
 
@@ -525,11 +627,38 @@ int MicroBitImage::paste(const MicroBitImage &image, int16_t x, int16_t y, uint8
     {
         for (int i=0; i<cy; i++)
         {
-            for (int j=0; j<cx; j++)
+            uint8_t *d = pOut;
+            const uint8_t *src = pIn;
+            int j = cx;
+
+            // Copy byte by byte until the destination is word aligned...
+            for (; j > 0 && ((uint32_t)d & 3); j--, d++, src++)
+            {
+                if (*src != 0){
+                    *d = *src;
+                    pxWritten++;
+                }
+            }
+
+            // ...then four pixels at a time, merging the non zero bytes under a mask.
+            for (; j >= 4; j -= 4, d += 4, src += 4)
+            {
+                uint32_t v = image_read_word(src);
+
+                if (v)
+                {
+                    uint32_t m = image_nonzero_bytes(v);
+
+                    // Zero bytes of v are already zero, so v needs no masking of its own.
+                    *(uint32_t *)d = (*(uint32_t *)d & ~(m * 0xff)) | v;
+                    pxWritten += (m * 0x01010101) >> 24;
+                }
+            }
+
+            for (; j > 0; j--, d++, src++)
             {
-                // Copy this byte if appropriate.
-                if (*(pIn+j) != 0){
-                    *(pOut+j) = *(pIn+j);
+                if (*src != 0){
+                    *d = *src;
                     pxWritten++;
                 }
             }
@@ -553,6 +682,76 @@ int MicroBitImage::paste(const MicroBitImage &image, int16_t x, int16_t y, uint8
     return pxWritten;
 }
 
+/**
+  * Pastes a given one bit per pixel bitmap at the given co-ordinates.
+  *
+  * Set pixels in the given image are written with the given value, clear pixels are written as 0.
+  *
+  * @param image The MicroBitMonoImage to paste.
+  *
+  * @param x The leftmost X co-ordinate in this image where the given image should be pasted. Defaults to 0.
+  *
+  * @param y The uppermost Y co-ordinate in this image where the given image should be pasted. Defaults to 0.
+  *
+  * @param alpha set to 1 if clear pixels in given image should be treated as transparent. Set to 0 otherwise.  Defaults to 0.
+  *
+  * @param value The brightness to write for set pixels. Defaults to 255.
+  *
+  * @return The number of pixels written.
+  *
+  * @code
+  * MicroBitMonoImage sprite(5,5);
+  * MicroBitImage i(5,5);
+  * i.paste(sprite, 0, 0, 1, 128);
+  * @endcode
+  */
+int MicroBitImage::paste(const MicroBitMonoImage &image, int16_t x, int16_t y, uint8_t alpha, uint8_t value)
+{
+    const uint32_t *pIn;
+    uint8_t *pOut;
+    int cx, cy, sx;
+    int pxWritten = 0;
+
+    // Sanity check.
+    if (x >= getWidth() || y >= getHeight() || x+image.getWidth() <= 0 || y+image.getHeight() <= 0)
+        return 0;
+
+    cx = x < 0 ? min(image.getWidth() + x, getWidth()) : min(image.getWidth(), getWidth() - x);
+    cy = y < 0 ? min(image.getHeight() + y, getHeight()) : min(image.getHeight(), getHeight() - y);
+    sx = x < 0 ? -x : 0;
+
+    pIn = image.getBitmap();
+    pIn += (y < 0) ? -image.getStride()*y : 0;
+
+    pOut = getMutableBitmap();
+    pOut += (x > 0) ? x : 0;
+    pOut += (y > 0) ? getWidth()*y : 0;
+
+    for (int i=0; i<cy; i++)
+    {
+        for (int j=0; j<cx; j++)
+        {
+            int b = sx + j;
+
+            if ((pIn[b >> 5] >> (b & 31)) & 1)
+            {
+                pOut[j] = value;
+                pxWritten++;
+            }
+            else if (!alpha)
+            {
+                pOut[j] = 0;
+                pxWritten++;
+            }
+        }
+
+        pIn += image.getStride();
+        pOut += getWidth();
+    }
+
+    return pxWritten;
+}
+
 /**
   * Prints a character to the display at the given location
   *
@@ -571,35 +770,29 @@ int MicroBitImage::paste(const MicroBitImage &image, int16_t x, int16_t y, uint8
   */
 int MicroBitImage::print(char c, int16_t x, int16_t y)
 {
-    unsigned char v;
-    int x1, y1;
-
-    MicroBitFont font = MicroBitFont::getSystemFont();
+    MicroBitGlyph glyph;
 
     // Sanity check. Silently ignore anything out of bounds.
-    if (x >= getWidth() || y >= getHeight() || c < MICROBIT_FONT_ASCII_START || c > font.asciiEnd)
+    if (x >= getWidth() || y >= getHeight() || MicroBitFont::systemFont.getGlyph(c, &glyph) != MICROBIT_OK)
         return MICROBIT_INVALID_PARAMETER;
 
-    // Paste.
-    int offset = (c-MICROBIT_FONT_ASCII_START) * 5;
-
-    for (int row=0; row<MICROBIT_FONT_HEIGHT; row++)
-    {
-        v = (char)*(font.characters + offset);
+    // Clip the glyph to the image once, rather than testing every pixel.
+    int width = getWidth();
+    int startCol = max(0, -x);
+    int startRow = max(0, -y);
+    int endCol = min(MICROBIT_FONT_WIDTH, width - x);
+    int endRow = min(MICROBIT_FONT_HEIGHT, getHeight() - y);
 
-        offset++;
+    uint8_t *bitmap = getMutableBitmap() + (y + startRow) * width + x;
 
-        // Update our Y co-ord write position
-        y1 = y+row;
+    for (int row = startRow; row < endRow; row++)
+    {
+        uint8_t v = glyph.rows[row];
 
-        for (int col = 0; col < MICROBIT_FONT_WIDTH; col++)
-        {
-            // Update our X co-ord write position
-            x1 = x+col;
+        for (int col = startCol; col < endCol; col++)
+            bitmap[col] = (v & (1 << col)) ? 255 : 0;
 
-            if (x1 < getWidth() && y1 < getHeight())
-                this->getBitmap()[y1*getWidth()+x1] = (v & (0x10 >> col)) ? 255 : 0;
-        }
+        bitmap += width;
     }
 
     return MICROBIT_OK;
@@ -621,7 +814,7 @@ int MicroBitImage::print(char c, int16_t x, int16_t y)
   */
 int MicroBitImage::shiftLeft(int16_t n)
 {
-    uint8_t *p = getBitmap();
+    uint8_t *p = getMutableBitmap();
     int pixels = getWidth()-n;
 
     if (n <= 0 )
@@ -633,13 +826,10 @@ int MicroBitImage::shiftLeft(int16_t n)
         return MICROBIT_OK;
     }
 
-    for (int y = 0; y < getHeight(); y++)
-    {
-        // Copy, and blank fill the rightmost column.
-        memcpy(p, p+n, pixels);
-        memclr(p+pixels, n);
-        p += getWidth();
-    }
+    // Rows are stored back to back, so moving the whole bitmap by n bytes shifts every row at once
+    // in a single block move, which the library performs a word at a time. Only the columns that wrapped in from the next row need blanking.
+    memmove(p, p+n, getWidth() * getHeight() - n);
+    image_clear_columns(p, getWidth(), getHeight(), pixels, n);
 
     return MICROBIT_OK;
 }
@@ -660,8 +850,7 @@ int MicroBitImage::shiftLeft(int16_t n)
   */
 int MicroBitImage::shiftRight(int16_t n)
 {
-    uint8_t *p = getBitmap();
-    int pixels = getWidth()-n;
+    uint8_t *p = getMutableBitmap();
 
     if (n <= 0)
         return MICROBIT_INVALID_PARAMETER;
@@ -672,13 +861,9 @@ int MicroBitImage::shiftRight(int16_t n)
         return MICROBIT_OK;
     }
 
-    for (int y = 0; y < getHeight(); y++)
-    {
-        // Copy, and blank fill the leftmost column.
-        memmove(p+n, p, pixels);
-        memclr(p, n);
-        p += getWidth();
-    }
+    // As for shiftLeft, move the whole bitmap in one block and blank the columns wrapped in from the previous row.
+    memmove(p+n, p, getWidth() * getHeight() - n);
+    image_clear_columns(p, getWidth(), getHeight(), 0, n);
 
     return MICROBIT_OK;
 }
@@ -710,8 +895,8 @@ int MicroBitImage::shiftUp(int16_t n)
         return MICROBIT_OK;
     }
 
-    pOut = getBitmap();
-    pIn = getBitmap()+getWidth()*n;
+    pOut = getMutableBitmap();
+    pIn = pOut+getWidth()*n;
 
     for (int y = 0; y < getHeight(); y++)
     {
@@ -755,7 +940,7 @@ int MicroBitImage::shiftDown(int16_t n)
         return MICROBIT_OK;
     }
 
-    pOut = getBitmap() + getWidth()*(getHeight()-1);
+    pOut = getMutableBitmap() + getWidth()*(getHeight()-1);
     pIn = pOut - getWidth()*n;
 
     for (int y = 0; y < getHeight(); y++)
@@ -793,7 +978,7 @@ ManagedString MicroBitImage::toString()
 
     parseBuffer[stringSize] = '\0';
 
-    uint8_t *bitmapPtr = getBitmap();
+    const uint8_t *bitmapPtr = getBitmap();
 
     int parseIndex = 0;
     int widthCount = 0;
@@ -857,7 +1042,7 @@ MicroBitImage MicroBitImage::crop(int startx, int starty, int cropWidth, int cro
     uint8_t cropped[newWidth * newHeight];
 
     //calculate the pointer to where we want to begin cropping
-    uint8_t *copyPointer = getBitmap() + (getWidth() * starty) + startx;
+    const uint8_t *copyPointer = getBitmap() + (getWidth() * starty) + startx;
 
     //get a reference to our storage
     uint8_t *pastePointer = cropped;
@@ -883,7 +1068,10 @@ bool MicroBitImage::isReadOnly()
 }
 
 /**
-  * Create a copy of the image bitmap. Used particularly, when isReadOnly() is true.
+  * Create a copy of the image bitmap.
+  *
+  * As MicroBitImage is copy-on-write, this is no longer needed before modifying a shared
+  * or read-only image; it simply forces the copy to happen now.
   *
   * @return an instance of MicroBitImage which can be modified independently of the current instance
   */
@@ -0,0 +1,158 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 British Broadcasting Corporation.
+This software is provided by Lancaster University by arrangement with the BBC.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+  * Class definition for a MicroBitImageAtlas.
+  *
+  * A MicroBitImageAtlas is a read-only set of equally sized images, compressed and kept in flash.
+  */
+
+#include "MicroBitConfig.h"
+#include "MicroBitImageAtlas.h"
+#include "MicroBitCompat.h"
+#include "ErrorNo.h"
+
+/**
+  * Constructor.
+  * Create an atlas from a specially prepared constant array, with no copying.
+  *
+  * @param data The atlas: width, height and frame count as 16 bit values, a 16 bit offset for each
+  *             frame, then the compressed frames. The array has to be 2-byte aligned.
+  */
+MicroBitImageAtlas::MicroBitImageAtlas(const uint8_t *data)
+{
+    atlas = (const ImageAtlasData *)(const void *)data;
+}
+
+/**
+  * Decodes a frame directly into the given image, at the given co-ordinates.
+  *
+  * Only the part of the frame that lands within the image is written, and nothing is
+  * allocated beyond the copy-on-write of the destination, should it be shared.
+  *
+  * @param image The MicroBitImage to write to.
+  *
+  * @param frame The index of the frame to decode.
+  *
+  * @param x The leftmost X co-ordinate in the image where the frame should be placed. Defaults to 0.
+  *
+  * @param y The uppermost Y co-ordinate in the image where the frame should be placed. Defaults to 0.
+  *
+  * @param alpha set to 1 if zero pixels in the frame should be treated as transparent. Set to 0 otherwise. Defaults to 0.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the frame does not exist.
+  */
+int MicroBitImageAtlas::paste(MicroBitImage &image, int frame, int16_t x, int16_t y, uint8_t alpha) const
+{
+    if (frame < 0 || frame >= getFrameCount())
+        return MICROBIT_INVALID_PARAMETER;
+
+    int w = getWidth();
+    int h = getHeight();
+    int imageWidth = image.getWidth();
+    int imageHeight = image.getHeight();
+
+    // Nothing to do if the frame lies entirely outside the image.
+    if (x >= imageWidth || y >= imageHeight || x + w <= 0 || y + h <= 0)
+        return MICROBIT_OK;
+
+    const uint8_t *in = getFrameData(frame);
+    uint8_t *out = image.getMutableBitmap();
+
+    // Stop decoding once we pass the bottom of either the frame or the image.
+    int rows = min(h, imageHeight - y);
+    int row = 0;
+    int col = 0;
+
+    while (row < rows)
+    {
+        uint8_t packet = *in++;
+        int run = (packet & 0x7f) + 1;
+        bool repeat = packet & 0x80;
+        uint8_t value = repeat ? *in++ : 0;
+
+        // Split each packet into spans that fit within a single row, and clip those against the image.
+        while (run > 0 && row < rows)
+        {
+            int n = min(run, w - col);
+            int x0 = max(x + col, 0);
+            int x1 = min(x + col + n, imageWidth);
+
+            if (y + row >= 0 && x1 > x0)
+            {
+                uint8_t *d = out + (y + row) * imageWidth + x0;
+
+                if (repeat)
+                {
+                    if (value || !alpha)
+                        memset(d, value, x1 - x0);
+                }
+                else
+                {
+                    const uint8_t *s = in + (x0 - (x + col));
+
+                    if (!alpha)
+                        memcpy(d, s, x1 - x0);
+                    else
+                        for (int i = 0; i < x1 - x0; i++)
+                            if (s[i])
+                                d[i] = s[i];
+                }
+            }
+
+            if (!repeat)
+                in += n;
+
+            run -= n;
+            col += n;
+
+            if (col == w)
+            {
+                col = 0;
+                row++;
+            }
+        }
+    }
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Decodes a frame into a new MicroBitImage.
+  *
+  * @param frame The index of the frame to decode.
+  *
+  * @return A new MicroBitImage holding the frame, or the empty image if the frame does not exist.
+  */
+MicroBitImage MicroBitImageAtlas::getFrame(int frame) const
+{
+    if (frame < 0 || frame >= getFrameCount())
+        return MicroBitImage();
+
+    MicroBitImage image(getWidth(), getHeight());
+    paste(image, frame);
+
+    return image;
+}
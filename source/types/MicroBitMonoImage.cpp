@@ -0,0 +1,749 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 British Broadcasting Corporation.
+This software is provided by Lancaster University by arrangement with the BBC.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+  * Class definition for a MicroBitMonoImage.
+  *
+  * A MicroBitMonoImage is a bitmap with one bit per pixel.
+  * n.b. This is a mutable, managed type.
+  */
+
+#include "MicroBitConfig.h"
+#include "MicroBitMonoImage.h"
+#include "MicroBitFont.h"
+#include "MicroBitCompat.h"
+#include "MicroBitPool.h"
+#include "ErrorNo.h"
+
+
+/**
+  * The null image. We actally create a small one word buffer here, just to keep NULL pointers out of the equation.
+  */
+static const uint16_t empty[] __attribute__ ((aligned (4))) = { 0xffff, 1, 1, 0, 0, 0, };
+MicroBitMonoImage MicroBitMonoImage::EmptyImage((MonoImageData*)(void*)empty);
+
+/**
+  * Counts the number of set bits in the given word, without branching or lookup tables.
+  */
+static inline int mono_popcount(uint32_t v)
+{
+    v = v - ((v >> 1) & 0x55555555);
+    v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+
+    return (((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+/**
+  * Reads the 32 pixels of a packed row that start at the given pixel.
+  * Pixels beyond the end of the row are read as clear.
+  */
+static inline uint32_t mono_fetch(const uint32_t *row, int bit, int stride)
+{
+    int w = bit >> 5;
+    int s = bit & 31;
+    uint32_t v = row[w] >> s;
+
+    if (s && w + 1 < stride)
+        v |= row[w + 1] << (32 - s);
+
+    return v;
+}
+
+/**
+  * Copies a run of pixels from one packed row to another, up to 32 pixels at a time.
+  *
+  * @param dst The row to write to.
+  *
+  * @param dstBit The first pixel to write in dst.
+  *
+  * @param src The row to read from.
+  *
+  * @param srcBit The first pixel to read in src.
+  *
+  * @param srcStride The length of src, in words.
+  *
+  * @param count The number of pixels to copy.
+  *
+  * @param alpha If set, only set pixels are copied, and the rest of dst is left unchanged.
+  *
+  * @return The number of pixels written.
+  */
+static int mono_blit(uint32_t *dst, int dstBit, const uint32_t *src, int srcBit, int srcStride, int count, bool alpha)
+{
+    int written = 0;
+
+    while (count > 0)
+    {
+        uint32_t *d = dst + (dstBit >> 5);
+        int s = dstBit & 31;
+        int n = min(count, 32 - s);
+
+        uint32_t mask = (n == 32 ? 0xffffffff : (((uint32_t)1 << n) - 1)) << s;
+        uint32_t v = (mono_fetch(src, srcBit, srcStride) << s) & mask;
+
+        if (alpha)
+        {
+            *d |= v;
+            written += mono_popcount(v);
+        }
+        else
+        {
+            *d = (*d & ~mask) | v;
+            written += n;
+        }
+
+        dstBit += n;
+        srcBit += n;
+        count -= n;
+    }
+
+    return written;
+}
+
+/**
+  * Default Constructor.
+  * Creates a new reference to the empty MicroBitMonoImage bitmap
+  *
+  * @code
+  * MicroBitMonoImage i(); //an empty image instance
+  * @endcode
+  */
+MicroBitMonoImage::MicroBitMonoImage()
+{
+    // Create new reference to the EmptyImage and we're done.
+    init_empty();
+}
+
+/**
+  * Constructor.
+  * Create a blank bitmap representation of a given size.
+  *
+  * @param x the width of the image.
+  *
+  * @param y the height of the image.
+  *
+  * A copy of the image is made in RAM, as images are mutable.
+  */
+MicroBitMonoImage::MicroBitMonoImage(const int16_t x, const int16_t y)
+{
+    this->init(x,y);
+}
+
+/**
+  * Copy Constructor.
+  * Add ourselves as a reference to an existing MicroBitMonoImage.
+  *
+  * @param image The MicroBitMonoImage to reference.
+  *
+  * @code
+  * MicroBitMonoImage i(5,5);
+  * MicroBitMonoImage i2(i); //points to i
+  * @endcode
+  */
+MicroBitMonoImage::MicroBitMonoImage(const MicroBitMonoImage &image)
+{
+    ptr = image.ptr;
+    ptr->incr();
+}
+
+/**
+  * Constructor.
+  * Create an image from a specially prepared constant array, with no copying. Will call ptr->incr().
+  *
+  * @param ptr The literal - the first word should be 0xffff | width << 16, the second the height,
+  *            then each row of the bitmap, padded to a whole number of words with zeroes.
+  *            The literal has to be 4-byte aligned.
+  *
+  * @code
+  * static const uint32_t heart[] __attribute__ ((aligned (4))) = { 0x0005ffff, 5, 0x0a, 0x1f, 0x1f, 0x0e, 0x04 }; // a cute heart
+  * MicroBitMonoImage i((MonoImageData*)(void*)heart);
+  * @endcode
+  */
+MicroBitMonoImage::MicroBitMonoImage(MonoImageData *p)
+{
+    if(p == NULL)
+    {
+        init_empty();
+        return;
+    }
+
+    ptr = p;
+    ptr->incr();
+}
+
+/**
+  * Constructor.
+  * Create a packed copy of the given image. Any non zero pixel is set.
+  *
+  * @param image The MicroBitImage to convert.
+  *
+  * @code
+  * MicroBitImage i("0,255,0,255,0\n255,255,255,255,255\n255,255,255,255,255\n0,255,255,255,0\n0,0,255,0,0\n");
+  * MicroBitMonoImage heart(i);
+  * @endcode
+  */
+MicroBitMonoImage::MicroBitMonoImage(MicroBitImage image)
+{
+    this->init(image.getWidth(), image.getHeight());
+
+    const uint8_t *pIn = image.getBitmap();
+    uint32_t *pOut = getMutableBitmap();
+
+    for (int y = 0; y < getHeight(); y++)
+    {
+        for (int x = 0; x < getWidth(); x++)
+            if (*pIn++)
+                pOut[x >> 5] |= (uint32_t)1 << (x & 31);
+
+        pOut += getStride();
+    }
+}
+
+/**
+  * Destructor.
+  *
+  * Removes buffer resources held by the instance.
+  */
+MicroBitMonoImage::~MicroBitMonoImage()
+{
+    ptr->decr();
+}
+
+/**
+  * Internal constructor which defaults to the EmptyImage instance variable
+  */
+void MicroBitMonoImage::init_empty()
+{
+    ptr = (MonoImageData*)(void*)empty;
+}
+
+/**
+  * Ensures this instance holds the only reference to its bitmap, so it can be written
+  * without affecting any other MicroBitMonoImage.
+  *
+  * Bitmaps that are shared, or that reside in flash, are copied into RAM and this
+  * instance is moved onto the copy. A bitmap we already own outright is left alone.
+  */
+void MicroBitMonoImage::unshare()
+{
+    // A count of 3 is a single outstanding reference (see RefCounted::init).
+    if (ptr->refCount == 3)
+        return;
+
+    MonoImageData *copy = (MonoImageData*)microbit_pool_alloc(sizeof(MonoImageData) + getSize());
+
+    // Writing on regardless would corrupt every other user of the shared bitmap, or fault on flash.
+    if (copy == NULL)
+        microbit_panic(MICROBIT_OOM);
+
+    copy->init();
+    copy->width = ptr->width;
+    copy->height = ptr->height;
+    memcpy(copy->data, ptr->data, getSize());
+
+    ptr->decr();
+    ptr = copy;
+}
+
+/**
+  * Internal constructor which provides sanity checking and initialises class properties.
+  *
+  * @param x the width of the image
+  *
+  * @param y the height of the image
+  */
+void MicroBitMonoImage::init(const int16_t x, const int16_t y)
+{
+    //sanity check size of image - you cannot have a negative sizes
+    if(x < 0 || y < 0)
+    {
+        init_empty();
+        return;
+    }
+
+    ptr = (MonoImageData*)microbit_pool_alloc(sizeof(MonoImageData) + ((x + 31) >> 5) * 4 * y);
+    ptr->init();
+    ptr->width = x;
+    ptr->height = y;
+
+    // Pixels beyond the width of each row are always kept clear, so whole words can be copied and compared.
+    this->clear();
+}
+
+/**
+  * Copy assign operation.
+  *
+  * Called when one MicroBitMonoImage is assigned the value of another using the '=' operator.
+  *
+  * Decrement our reference count and free up the buffer as necessary.
+  *
+  * Then, update our buffer to refer to that of the supplied MicroBitMonoImage,
+  * and increase its reference count.
+  *
+  * @param i The MicroBitMonoImage to reference.
+  */
+MicroBitMonoImage& MicroBitMonoImage::operator = (const MicroBitMonoImage& i)
+{
+    if(ptr == i.ptr)
+        return *this;
+
+    ptr->decr();
+    ptr = i.ptr;
+    ptr->incr();
+
+    return *this;
+}
+
+#if CONFIG_ENABLED(MICROBIT_MOVE_SEMANTICS)
+/**
+  * Move constructor.
+  * Takes over the data of a MicroBitMonoImage that is about to be destroyed, without
+  * changing its reference count.
+  *
+  * @param i The MicroBitMonoImage to move from. It is left as the empty image.
+  */
+MicroBitMonoImage::MicroBitMonoImage(MicroBitMonoImage &&i)
+{
+    ptr = i.ptr;
+    i.init_empty();
+}
+
+/**
+  * Move assign operation.
+  * Releases our current data, and takes over that of a MicroBitMonoImage that is about to
+  * be destroyed, without changing its reference count.
+  *
+  * @param i The MicroBitMonoImage to move from. It is left as the empty image.
+  */
+MicroBitMonoImage& MicroBitMonoImage::operator = (MicroBitMonoImage &&i)
+{
+    if(this == &i)
+        return *this;
+
+    ptr->decr();
+    ptr = i.ptr;
+    i.init_empty();
+
+    return *this;
+}
+#endif
+
+/**
+  * Equality operation.
+  *
+  * Called when one MicroBitMonoImage is tested to be equal to another using the '==' operator.
+  *
+  * @param i The MicroBitMonoImage to test ourselves against.
+  *
+  * @return true if this MicroBitMonoImage is identical to the one supplied, false otherwise.
+  */
+bool MicroBitMonoImage::operator== (const MicroBitMonoImage& i)
+{
+    if (ptr == i.ptr)
+        return true;
+    else
+        return (ptr->width == i.ptr->width && ptr->height == i.ptr->height && (memcmp(getBitmap(), i.ptr->data, getSize())==0));
+}
+
+/**
+  * Clears all pixels in this image.
+  */
+void MicroBitMonoImage::clear()
+{
+    memclr(getMutableBitmap(), getSize());
+}
+
+/**
+  * Sets or clears the pixel at the given co-ordinates.
+  *
+  * @param x The co-ordinate of the pixel to change.
+  *
+  * @param y The co-ordinate of the pixel to change.
+  *
+  * @param value Any non zero value sets the pixel, zero clears it.
+  *
+  * @return MICROBIT_OK, or MICROBIT_INVALID_PARAMETER.
+  *
+  * @note all coordinates originate from the top left of an image.
+  */
+int MicroBitMonoImage::setPixelValue(int16_t x , int16_t y, uint8_t value)
+{
+    //sanity check
+    if(x >= getWidth() || y >= getHeight() || x < 0 || y < 0)
+        return MICROBIT_INVALID_PARAMETER;
+
+    uint32_t *p = getMutableBitmap() + y * getStride() + (x >> 5);
+
+    if (value)
+        *p |= (uint32_t)1 << (x & 31);
+    else
+        *p &= ~((uint32_t)1 << (x & 31));
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Retrieves the value of a given pixel.
+  *
+  * @param x The x co-ordinate of the pixel to read. Must be within the dimensions of the image.
+  *
+  * @param y The y co-ordinate of the pixel to read. Must be within the dimensions of the image.
+  *
+  * @return 255 if the pixel is set, 0 if it is clear, or MICROBIT_INVALID_PARAMETER.
+  */
+int MicroBitMonoImage::getPixelValue(int16_t x , int16_t y)
+{
+    //sanity check
+    if(x >= getWidth() || y >= getHeight() || x < 0 || y < 0)
+        return MICROBIT_INVALID_PARAMETER;
+
+    return (getBitmap()[y * getStride() + (x >> 5)] >> (x & 31)) & 1 ? 255 : 0;
+}
+
+/**
+  * Pastes a given bitmap at the given co-ordinates.
+  *
+  * Any pixels in the relevant area of this image are replaced.
+  *
+  * @param image The MicroBitMonoImage to paste.
+  *
+  * @param x The leftmost X co-ordinate in this image where the given image should be pasted. Defaults to 0.
+  *
+  * @param y The uppermost Y co-ordinate in this image where the given image should be pasted. Defaults to 0.
+  *
+  * @param alpha set to 1 if clear pixels in given image should be treated as transparent. Set to 0 otherwise.  Defaults to 0.
+  *
+  * @return The number of pixels written.
+  *
+  * @code
+  * MicroBitMonoImage sprite(5,5);
+  * MicroBitMonoImage screen(5,5);
+  * screen.paste(sprite, 1, 0, 1);
+  * @endcode
+  */
+int MicroBitMonoImage::paste(const MicroBitMonoImage &image, int16_t x, int16_t y, uint8_t alpha)
+{
+    const uint32_t *pIn;
+    uint32_t *pOut;
+    int cx, cy;
+    int pxWritten = 0;
+
+    // Sanity check.
+    // We permit writes that overlap us, but ones that are clearly out of scope we can filter early.
+    if (x >= getWidth() || y >= getHeight() || x+image.getWidth() <= 0 || y+image.getHeight() <= 0)
+        return 0;
+
+    //Calculate the number of pixels we need to copy in each dimension.
+    cx = x < 0 ? min(image.getWidth() + x, getWidth()) : min(image.getWidth(), getWidth() - x);
+    cy = y < 0 ? min(image.getHeight() + y, getHeight()) : min(image.getHeight(), getHeight() - y);
+
+    // Calculate sane start pointers.
+    pIn = image.ptr->data + ((y < 0) ? -y * image.getStride() : 0);
+    pOut = getMutableBitmap() + ((y > 0) ? y * getStride() : 0);
+
+    // Copy the image, row by row, a word at a time.
+    for (int i=0; i<cy; i++)
+    {
+        pxWritten += mono_blit(pOut, x > 0 ? x : 0, pIn, x < 0 ? -x : 0, image.getStride(), cx, alpha);
+
+        pIn += image.getStride();
+        pOut += getStride();
+    }
+
+    return pxWritten;
+}
+
+/**
+  * Prints a character to the image at the given location
+  *
+  * @param c The character to display.
+  *
+  * @param x The x co-ordinate of on the image to place the top left of the character. Defaults to 0.
+  *
+  * @param y The y co-ordinate of on the image to place the top left of the character. Defaults to 0.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER.
+  *
+  * @code
+  * MicroBitMonoImage i(5,5);
+  * i.print('a');
+  * @endcode
+  */
+int MicroBitMonoImage::print(char c, int16_t x, int16_t y)
+{
+    MicroBitGlyph glyph;
+
+    // Sanity check. Silently ignore anything out of bounds.
+    if (x >= getWidth() || y >= getHeight() || MicroBitFont::systemFont.getGlyph(c, &glyph) != MICROBIT_OK)
+        return MICROBIT_INVALID_PARAMETER;
+
+    int srcBit = x < 0 ? -x : 0;
+    int dstBit = x < 0 ? 0 : x;
+    int count = min(MICROBIT_FONT_WIDTH - srcBit, getWidth() - dstBit);
+
+    for (int row=0; row<MICROBIT_FONT_HEIGHT; row++)
+    {
+        int y1 = y + row;
+
+        if (count <= 0 || y1 < 0 || y1 >= getHeight())
+            continue;
+
+        // Glyph rows already hold their leftmost pixel in bit 0, as we do.
+        uint32_t bits = glyph.rows[row];
+
+        mono_blit(getMutableBitmap() + y1 * getStride(), dstBit, &bits, srcBit, 1, count, false);
+    }
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Shifts the pixels in this Image a given number of pixels to the left.
+  *
+  * @param n The number of pixels to shift.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER.
+  */
+int MicroBitMonoImage::shiftLeft(int16_t n)
+{
+    uint32_t *p = getMutableBitmap();
+    int stride = getStride();
+    int q = n >> 5;
+    int r = n & 31;
+
+    if (n <= 0 )
+        return MICROBIT_INVALID_PARAMETER;
+
+    if(n >= getWidth())
+    {
+        clear();
+        return MICROBIT_OK;
+    }
+
+    // Move each row down by whole words, then funnel shift the remaining bits across word boundaries.
+    // The clear padding beyond the width of each row provides the blank fill on the right.
+    for (int y = 0; y < getHeight(); y++)
+    {
+        for (int i = 0; i < stride; i++)
+        {
+            uint32_t v = (i + q < stride) ? p[i + q] >> r : 0;
+
+            if (r && i + q + 1 < stride)
+                v |= p[i + q + 1] << (32 - r);
+
+            p[i] = v;
+        }
+
+        p += stride;
+    }
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Shifts the pixels in this Image a given number of pixels to the right.
+  *
+  * @param n The number of pixels to shift.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER.
+  */
+int MicroBitMonoImage::shiftRight(int16_t n)
+{
+    uint32_t *p = getMutableBitmap();
+    int stride = getStride();
+    int q = n >> 5;
+    int r = n & 31;
+    uint32_t lastMask = (getWidth() & 31) ? ((uint32_t)1 << (getWidth() & 31)) - 1 : 0xffffffff;
+
+    if (n <= 0)
+        return MICROBIT_INVALID_PARAMETER;
+
+    if(n >= getWidth())
+    {
+        clear();
+        return MICROBIT_OK;
+    }
+
+    for (int y = 0; y < getHeight(); y++)
+    {
+        for (int i = stride - 1; i >= 0; i--)
+        {
+            uint32_t v = (i - q >= 0) ? p[i - q] << r : 0;
+
+            if (r && i - q - 1 >= 0)
+                v |= p[i - q - 1] >> (32 - r);
+
+            p[i] = v;
+        }
+
+        // Discard anything shifted beyond the width of the image.
+        p[stride - 1] &= lastMask;
+        p += stride;
+    }
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Shifts the pixels in this Image a given number of pixels to upward.
+  *
+  * @param n The number of pixels to shift.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER.
+  */
+int MicroBitMonoImage::shiftUp(int16_t n)
+{
+    int rowSize = getStride() * 4;
+
+    if (n <= 0 )
+        return MICROBIT_INVALID_PARAMETER;
+
+    if(n >= getHeight())
+    {
+        clear();
+        return MICROBIT_OK;
+    }
+
+    uint32_t *p = getMutableBitmap();
+
+    memmove(p, p + getStride() * n, rowSize * (getHeight() - n));
+    memclr(p + getStride() * (getHeight() - n), rowSize * n);
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Shifts the pixels in this Image a given number of pixels to downward.
+  *
+  * @param n The number of pixels to shift.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER.
+  */
+int MicroBitMonoImage::shiftDown(int16_t n)
+{
+    int rowSize = getStride() * 4;
+
+    if (n <= 0 )
+        return MICROBIT_INVALID_PARAMETER;
+
+    if(n >= getHeight())
+    {
+        clear();
+        return MICROBIT_OK;
+    }
+
+    uint32_t *p = getMutableBitmap();
+
+    memmove(p + getStride() * n, p, rowSize * (getHeight() - n));
+    memclr(p, rowSize * n);
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Crops the image to the given dimensions.
+  *
+  * @param startx the location to start the crop in the x-axis
+  *
+  * @param starty the location to start the crop in the y-axis
+  *
+  * @param cropWidth the width of the desired cropped region
+  *
+  * @param cropHeight the height of the desired cropped region
+  *
+  * @return a new MicroBitMonoImage holding the part of the requested region that lies within this image.
+  */
+MicroBitMonoImage MicroBitMonoImage::crop(int startx, int starty, int cropWidth, int cropHeight)
+{
+    // Clip the requested region to the bounds of this image.
+    if (startx < 0)
+    {
+        cropWidth += startx;
+        startx = 0;
+    }
+
+    if (starty < 0)
+    {
+        cropHeight += starty;
+        starty = 0;
+    }
+
+    cropWidth = min(cropWidth, getWidth() - startx);
+    cropHeight = min(cropHeight, getHeight() - starty);
+
+    if (cropWidth <= 0 || cropHeight <= 0)
+        return MicroBitMonoImage();
+
+    MicroBitMonoImage cropped(cropWidth, cropHeight);
+    cropped.paste(*this, -startx, -starty);
+
+    return cropped;
+}
+
+/**
+  * Check if image is read-only (i.e., residing in flash).
+  */
+bool MicroBitMonoImage::isReadOnly()
+{
+    return ptr->isReadOnly();
+}
+
+/**
+  * Create a copy of the image bitmap. Used particularly, when isReadOnly() is true.
+  *
+  * @return an instance of MicroBitMonoImage which can be modified independently of the current instance
+  */
+MicroBitMonoImage MicroBitMonoImage::clone()
+{
+    MicroBitMonoImage copy(getWidth(), getHeight());
+    memcpy(copy.getMutableBitmap(), getBitmap(), getSize());
+
+    return copy;
+}
+
+/**
+  * Converts this image into a MicroBitImage, with one byte per pixel.
+  *
+  * @param value The brightness to give set pixels. Defaults to 255.
+  *
+  * @return a new MicroBitImage of the same size.
+  */
+MicroBitImage MicroBitMonoImage::toImage(uint8_t value)
+{
+    MicroBitImage image(getWidth(), getHeight());
+
+    uint8_t *pOut = image.getMutableBitmap();
+    const uint32_t *pIn = getBitmap();
+
+    for (int y = 0; y < getHeight(); y++)
+    {
+        for (int x = 0; x < getWidth(); x++)
+            *pOut++ = (pIn[x >> 5] >> (x & 31)) & 1 ? value : 0;
+
+        pIn += getStride();
+    }
+
+    return image;
+}
@@ -25,6 +25,7 @@ DEALINGS IN THE SOFTWARE.
 
 #include "MicroBitConfig.h"
 #include "PacketBuffer.h"
+#include "MicroBitPool.h"
 #include "ErrorNo.h"
 
 // Create the EmptyPacket reference.
@@ -94,6 +95,9 @@ PacketBuffer::PacketBuffer(const PacketBuffer &buffer)
 {
     ptr = buffer.ptr;
     ptr->incr();
+
+    offset = buffer.offset;
+    len = buffer.len;
 }
 
 /**
@@ -110,12 +114,15 @@ void PacketBuffer::init(uint8_t *data, int length, int rssi)
     if (length < 0)
         length = 0;
 
-    ptr = (PacketData *) malloc(sizeof(PacketData) + length);
+    ptr = (PacketData *) microbit_pool_alloc(sizeof(PacketData) + length);
     ptr->init();
 
     ptr->length = length;
     ptr->rssi = rssi;
 
+    offset = 0;
+    len = length;
+
     // Copy in the data buffer, if provided.
     if (data)
         memcpy(ptr->payload, data, length);
@@ -153,6 +160,9 @@ PacketBuffer::~PacketBuffer()
   */
 PacketBuffer& PacketBuffer::operator = (const PacketBuffer &p)
 {
+    offset = p.offset;
+    len = p.len;
+
     if(ptr == p.ptr)
         return *this;
 
@@ -163,6 +173,53 @@ PacketBuffer& PacketBuffer::operator = (const PacketBuffer &p)
     return *this;
 }
 
+#if CONFIG_ENABLED(MICROBIT_MOVE_SEMANTICS)
+/**
+  * Move constructor.
+  * Takes over the data of a PacketBuffer that is about to be destroyed, without
+  * changing its reference count.
+  *
+  * @param p The PacketBuffer to move from. It is left as an empty buffer.
+  */
+PacketBuffer::PacketBuffer(PacketBuffer &&p)
+{
+    // Leave the source holding a reference to the shared empty packet, so it remains usable.
+    ptr = p.ptr;
+    offset = p.offset;
+    len = p.len;
+
+    p.ptr = EmptyPacket.ptr;
+    p.ptr->incr();
+    p.offset = EmptyPacket.offset;
+    p.len = EmptyPacket.len;
+}
+
+/**
+  * Move assign operation.
+  * Exchanges our data with that of a PacketBuffer that is about to be destroyed,
+  * without changing either reference count.
+  *
+  * @param p The PacketBuffer to move from. It is left holding our previous data, which it releases when destroyed.
+  */
+PacketBuffer& PacketBuffer::operator = (PacketBuffer &&p)
+{
+    // Exchange payloads, so our old one is released when the source is destroyed.
+    PacketData *old = ptr;
+    uint8_t oldOffset = offset;
+    uint8_t oldLen = len;
+
+    ptr = p.ptr;
+    offset = p.offset;
+    len = p.len;
+
+    p.ptr = old;
+    p.offset = oldOffset;
+    p.len = oldLen;
+
+    return *this;
+}
+#endif
+
 /**
   * Array access operation (read).
   *
@@ -177,7 +234,7 @@ PacketBuffer& PacketBuffer::operator = (const PacketBuffer &p)
   */
 uint8_t PacketBuffer::operator [] (int i) const
 {
-    return ptr->payload[i];
+    return ptr->payload[offset + i];
 }
 
 /**
@@ -194,7 +251,7 @@ uint8_t PacketBuffer::operator [] (int i) const
   */
 uint8_t& PacketBuffer::operator [] (int i)
 {
-    return ptr->payload[i];
+    return ptr->payload[offset + i];
 }
 
 /**
@@ -218,10 +275,10 @@ uint8_t& PacketBuffer::operator [] (int i)
   */
 bool PacketBuffer::operator== (const PacketBuffer& p)
 {
-    if (ptr == p.ptr)
+    if (ptr == p.ptr && offset == p.offset && len == p.len)
         return true;
     else
-        return (ptr->length == p.ptr->length && (memcmp(ptr->payload, p.ptr->payload, ptr->length)==0));
+        return (len == p.len && (memcmp(ptr->payload + offset, p.ptr->payload + p.offset, len)==0));
 }
 
 /**
@@ -240,9 +297,9 @@ bool PacketBuffer::operator== (const PacketBuffer& p)
   */
 int PacketBuffer::setByte(int position, uint8_t value)
 {
-    if (position < ptr->length)
+    if (position < len)
     {
-        ptr->payload[position] = value;
+        ptr->payload[offset + position] = value;
         return MICROBIT_OK;
     }
     else
@@ -266,8 +323,8 @@ int PacketBuffer::setByte(int position, uint8_t value)
   */
 int PacketBuffer::getByte(int position)
 {
-    if (position < ptr->length)
-        return ptr->payload[position];
+    if (position < len)
+        return ptr->payload[offset + position];
     else
         return MICROBIT_INVALID_PARAMETER;
 }
@@ -279,7 +336,7 @@ int PacketBuffer::getByte(int position)
   */
 uint8_t*PacketBuffer::getBytes()
 {
-    return ptr->payload;
+    return ptr->payload + offset;
 }
 
 /**
@@ -294,7 +351,7 @@ uint8_t*PacketBuffer::getBytes()
   */
 int PacketBuffer::length()
 {
-    return ptr->length;
+    return len;
 }
 
 /**
@@ -325,3 +382,37 @@ void PacketBuffer::setRSSI(uint8_t rssi)
 {
     ptr->rssi = rssi;
 }
+
+/**
+  * Creates a PacketBuffer that refers to part of this one, without copying.
+  *
+  * The slice shares the data of this buffer, so changes made through either are seen by both.
+  * The range is clipped to the end of this buffer.
+  *
+  * @param offset The index of the first byte of the slice.
+  *
+  * @param length The number of bytes in the slice. Defaults to the rest of the buffer.
+  *
+  * @return A PacketBuffer referring to the requested bytes, or an empty buffer if offset is out of range.
+  *
+  * @code
+  * PacketBuffer p = uBit.radio.datagram.recv();
+  * PacketBuffer body = p.slice(2);         // Everything after a two byte header.
+  * @endcode
+  */
+PacketBuffer PacketBuffer::slice(int offset, int length)
+{
+    PacketBuffer p(*this);
+
+    if (offset < 0 || offset > len || length < 0)
+    {
+        p.offset = this->offset;
+        p.len = 0;
+        return p;
+    }
+
+    p.offset = this->offset + offset;
+    p.len = length < len - offset ? length : len - offset;
+
+    return p;
+}
@@ -30,6 +30,7 @@ DEALINGS IN THE SOFTWARE.
 #include "mbed.h"
 #include "MicroBitConfig.h"
 #include "RefCounted.h"
+#include "MicroBitPool.h"
 #include "MicroBitDisplay.h"
 
 /**
@@ -93,6 +94,6 @@ void RefCounted::decr()
 
     refCount -= 2;
     if (refCount == 1) {
-        free(this);
+        microbit_pool_free(this);
     }
 }
@@ -0,0 +1,433 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 British Broadcasting Corporation.
+This software is provided by Lancaster University by arrangement with the BBC.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+  * Class definition for a StringView.
+  *
+  * A StringView refers to a run of characters held elsewhere, without copying them.
+  */
+
+#include "MicroBitConfig.h"
+#include "StringView.h"
+#include "MicroBitCompat.h"
+#include "ErrorNo.h"
+#include <limits.h>
+
+/**
+  * Constructor.
+  * Creates an empty view.
+  */
+StringView::StringView()
+{
+    anchor = NULL;
+    packetAnchor = false;
+    data = "";
+    len = 0;
+}
+
+/**
+  * Constructor.
+  * Creates a view of a character buffer. The buffer is not copied, and must remain valid
+  * for as long as the view is used.
+  *
+  * @param str The characters to view.
+  *
+  * @param length The number of characters to view.
+  */
+StringView::StringView(const char *str, int16_t length)
+{
+    anchor = NULL;
+    packetAnchor = false;
+    data = str ? str : "";
+    len = (str && length > 0) ? length : 0;
+}
+
+/**
+  * Constructor.
+  * Creates a view of a NULL terminated string. The string is not copied, and must remain
+  * valid for as long as the view is used.
+  *
+  * @param str The characters to view.
+  */
+StringView::StringView(const char *str)
+{
+    anchor = NULL;
+    packetAnchor = false;
+    data = str ? str : "";
+    len = strlen(data);
+}
+
+/**
+  * Constructor.
+  * Creates a view of the whole of a ManagedString. The characters are not copied.
+  *
+  * @param s The ManagedString to view.
+  */
+StringView::StringView(const ManagedString &s)
+{
+    // Inline strings live inside the ManagedString, which may not outlive us, so these are copied.
+    StringData *p = s.toStringData();
+
+    anchor = p;
+    packetAnchor = false;
+    data = p->data;
+    len = p->len;
+}
+
+/**
+  * Constructor.
+  * Creates a view of part of a ManagedString. The characters are not copied.
+  * The range is clipped to the end of the string.
+  *
+  * @param s The ManagedString to view.
+  *
+  * @param start The index of the first character to view.
+  *
+  * @param length The number of characters to view.
+  */
+StringView::StringView(const ManagedString &s, int16_t start, int16_t length)
+{
+    StringData *p = s.toStringData();
+
+    anchor = p;
+    packetAnchor = false;
+    data = p->data;
+    len = 0;
+
+    if (start >= 0 && start < p->len && length > 0)
+    {
+        data += start;
+        len = min(p->len - start, length);
+    }
+}
+
+/**
+  * Constructor.
+  * Creates a view of the bytes of a PacketBuffer, such as a received radio datagram,
+  * as characters. The bytes are not copied, so later changes to the buffer are seen by the view.
+  *
+  * @param buffer The PacketBuffer to view.
+  */
+StringView::StringView(PacketBuffer buffer)
+{
+    anchor = buffer.ptr;
+    anchor->incr();
+    packetAnchor = true;
+
+    data = (const char *)buffer.getBytes();
+    len = buffer.length();
+}
+
+/**
+  * Internal constructor, referring to part of the given view's characters.
+  */
+StringView::StringView(const StringView &view, int16_t start, int16_t length)
+{
+    anchor = view.anchor;
+    packetAnchor = view.packetAnchor;
+
+    if (anchor)
+        anchor->incr();
+
+    data = view.data;
+    len = 0;
+
+    if (start >= 0 && start < view.len && length > 0)
+    {
+        data += start;
+        len = min(view.len - start, length);
+    }
+}
+
+/**
+  * Copy constructor.
+  * Refers to the same characters as the given view.
+  *
+  * @param view The StringView to copy.
+  */
+StringView::StringView(const StringView &view)
+{
+    anchor = view.anchor;
+    packetAnchor = view.packetAnchor;
+
+    if (anchor)
+        anchor->incr();
+
+    data = view.data;
+    len = view.len;
+}
+
+/**
+  * Destructor.
+  *
+  * Releases our reference to the underlying ManagedString data, if any.
+  */
+StringView::~StringView()
+{
+    if (anchor)
+        anchor->decr();
+}
+
+/**
+  * Copy assign operation.
+  *
+  * @param view The StringView to refer to.
+  */
+StringView& StringView::operator = (const StringView &view)
+{
+    // Take the new reference first, in case both views share the same anchor.
+    if (view.anchor)
+        view.anchor->incr();
+
+    if (anchor)
+        anchor->decr();
+
+    anchor = view.anchor;
+    packetAnchor = view.packetAnchor;
+    data = view.data;
+    len = view.len;
+
+    return *this;
+}
+
+#if CONFIG_ENABLED(MICROBIT_MOVE_SEMANTICS)
+/**
+  * Move constructor.
+  * Takes over the data of a StringView that is about to be destroyed, without
+  * changing its reference count.
+  *
+  * @param view The StringView to move from. It is left as an empty view.
+  */
+StringView::StringView(StringView &&view)
+{
+    anchor = view.anchor;
+    packetAnchor = view.packetAnchor;
+    data = view.data;
+    len = view.len;
+
+    view.anchor = NULL;
+    view.packetAnchor = false;
+    view.data = "";
+    view.len = 0;
+}
+
+/**
+  * Move assign operation.
+  * Releases our current data, and takes over that of a StringView that is about to
+  * be destroyed, without changing its reference count.
+  *
+  * @param view The StringView to move from. It is left as an empty view.
+  */
+StringView& StringView::operator = (StringView &&view)
+{
+    if(this == &view)
+        return *this;
+
+    if (anchor)
+        anchor->decr();
+
+    anchor = view.anchor;
+    packetAnchor = view.packetAnchor;
+    data = view.data;
+    len = view.len;
+
+    view.anchor = NULL;
+    view.packetAnchor = false;
+    view.data = "";
+    view.len = 0;
+
+    return *this;
+}
+#endif
+
+/**
+  * Equality operation.
+  *
+  * @param view The characters to compare against.
+  *
+  * @return true if both views hold the same characters, false otherwise.
+  */
+bool StringView::operator== (const StringView &view) const
+{
+    return len == view.len && (data == view.data || memcmp(data, view.data, len) == 0);
+}
+
+/**
+  * Creates a view of part of this view, without copying.
+  *
+  * @param start The index of the first character.
+  *
+  * @param length The number of characters, clipped to the end of this view.
+  *
+  * @return A StringView of the requested characters, or an empty view if start is out of range.
+  */
+StringView StringView::substring(int16_t start, int16_t length) const
+{
+    return StringView(*this, start, length);
+}
+
+/**
+  * Finds the first occurrence of a character.
+  *
+  * @param c The character to look for.
+  *
+  * @param start The index to start looking from. Defaults to 0.
+  *
+  * @return The index of the character, or -1 if it does not occur.
+  */
+int16_t StringView::indexOf(char c, int16_t start) const
+{
+    if (start < 0 || start >= len)
+        return -1;
+
+    const char *p = (const char *)memchr(data + start, c, len - start);
+
+    return p ? p - data : -1;
+}
+
+/**
+  * Determines if this view begins with the given characters.
+  *
+  * @param prefix The characters to look for.
+  *
+  * @return true if the view starts with prefix, false otherwise.
+  */
+bool StringView::startsWith(const StringView &prefix) const
+{
+    return prefix.len <= len && memcmp(data, prefix.data, prefix.len) == 0;
+}
+
+/**
+  * Removes the next token from the front of this view.
+  *
+  * Runs of the delimiter are skipped, so empty tokens are never returned.
+  *
+  * @param token Set to a view of the next token.
+  *
+  * @param delimiter The character that separates tokens.
+  *
+  * @return true if a token was found, false if none remain.
+  */
+bool StringView::nextToken(StringView &token, char delimiter)
+{
+    int start = 0;
+
+    while (start < len && data[start] == delimiter)
+        start++;
+
+    if (start == len)
+    {
+        data += len;
+        len = 0;
+        return false;
+    }
+
+    int end = indexOf(delimiter, start);
+
+    if (end < 0)
+        end = len;
+
+    token = StringView(*this, start, end - start);
+
+    // Consume the token, and the delimiter that ended it.
+    end = min(end + 1, len);
+    data += end;
+    len -= end;
+
+    return true;
+}
+
+/**
+  * Parses the view as a decimal integer, with an optional leading sign.
+  *
+  * @param value Set to the parsed integer.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the view is not a decimal integer
+  *         or is out of the range of an int.
+  */
+int StringView::toInt(int &value) const
+{
+    int i = 0;
+    bool negative = false;
+    uint32_t result = 0;
+
+    if (len > 0 && (data[0] == '-' || data[0] == '+'))
+    {
+        negative = data[0] == '-';
+        i++;
+    }
+
+    if (i == len)
+        return MICROBIT_INVALID_PARAMETER;
+
+    // The magnitude of INT_MIN is one more than INT_MAX.
+    uint32_t limit = negative ? (uint32_t)INT_MAX + 1 : (uint32_t)INT_MAX;
+
+    for (; i < len; i++)
+    {
+        // Compare rather than use isdigit(), which is undefined for the negative chars of bytes above 0x7F.
+        if (data[i] < '0' || data[i] > '9')
+            return MICROBIT_INVALID_PARAMETER;
+
+        uint32_t digit = data[i] - '0';
+
+        if (result > (limit - digit) / 10)
+            return MICROBIT_INVALID_PARAMETER;
+
+        result = result * 10 + digit;
+    }
+
+    value = negative ? (int)(0 - result) : (int)result;
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Creates a ManagedString holding the characters of this view.
+  *
+  * No copy is made if the view covers the whole of a ManagedString.
+  *
+  * @return A ManagedString holding the same characters.
+  */
+ManagedString StringView::toManagedString() const
+{
+    // Views of a whole ManagedString can simply share its data.
+    if (anchor && !packetAnchor)
+    {
+        StringData *s = (StringData *)anchor;
+
+        if (data == s->data && len == s->len)
+            return ManagedString(s);
+    }
+
+    if (len == 0)
+        return ManagedString::EmptyString;
+
+    // Copy into a new string, held inline if it is short enough. Our characters are not NULL terminated.
+    ManagedString r;
+    memcpy(r.initBuffer(len), data, len);
+
+    return r;
+}